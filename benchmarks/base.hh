@@ -35,6 +35,8 @@
 
 #include <iostream>
 #include "utils/configs.h"
+#include "utils/metrics.hh"
+#include "utils/m5lib/phases.hh"
 #include <list>
 
 
@@ -50,10 +52,15 @@ protected:
 
   bool initialized;
 
+  /** Run the null variant of exec(): the same loop and loads with the
+   *  measured construct (branch, call, load) removed */
+  bool null_variant;
+
 public:
   BaseBenchmark(std::string name)
       : _name(name),
-        initialized(false)
+        initialized(false),
+        null_variant(false)
   {
   }
   virtual ~BaseBenchmark() {}
@@ -71,15 +78,50 @@ public:
   /** Report results of the benchmark if needed */
   virtual void report() {}
 
+  /** Add the results of the last repeat as named metrics. Called by the
+   *  runner after every measured repeat, outside of the measured region */
+  virtual void metrics(MetricSink &sink) {}
+
   /** Repeat ended. Can be used to reset something to make each repeat
    * deterministic */
   virtual void repeat() {}
 
+  /** True if exec() implements a null variant. The runner subtracts
+   *  the null variant from the measurement to get the net cost of the
+   *  measured construct. */
+  virtual bool hasNull() const { return false; }
+
+  void setNull(bool enable) { null_variant = enable; }
+
+  /** Number of operations (e.g. executed branches, loads or searches)
+   *  in the last exec(). The runner divides the time and the counters
+   *  by it to report the cost per operation. 0 if unknown. */
+  virtual double opCount() const { return 0; }
+
+  /** Unit of an operation of opCount(), e.g. "branches" */
+  virtual std::string opUnit() const { return "ops"; }
+
+  /** Mark a sub-region of exec(), e.g. a warm and a measured part. With
+   *  the region phase enabled (--m5-phases region) the gem5 stats are
+   *  reset at the begin and dumped with the name at the end. */
+  void regionBegin() { phaseMarker().begin(Phase::Region); }
+  void regionEnd(const char *name) { phaseMarker().end(Phase::Region, name); }
+
   std::string getName() const {
     return _name;
   }
 };
 
 
+/** Keep a value alive without generating code for it, such that the
+ *  compiler cannot remove the computation of a null variant. The value
+ *  must fit into a register. There is no memory clobber, so the state of
+ *  the loop can stay in registers like in the measured loop. */
+template <typename T>
+inline void doNotOptimize(T &value)
+{
+  asm volatile("" : "+r"(value));
+}
+
 BaseBenchmark* createBenchmark(const std::string& name);
 void listBenchmarks();
\ No newline at end of file
@@ -38,6 +38,7 @@
 
 #include "benchmarks/base.hh"
 #include "benchmarks/registry.hh"
+#include "utils/memory.hh"
 
 class BinarySearch : public BaseBenchmark {
  private:
@@ -46,6 +47,7 @@ class BinarySearch : public BaseBenchmark {
   int *A;
   int *keys;
   int found_keys;
+  Arena arena;
 
 
  public:
@@ -54,17 +56,9 @@ class BinarySearch : public BaseBenchmark {
         num_keys(100),
         array_size(100),
         A(nullptr),
+        keys(nullptr),
         found_keys(0) {}
 
-  ~BinarySearch() {
-    if (A) {
-      delete A;
-    }
-    if (keys) {
-      delete keys;
-    }
-  }
-
   bool init(YAML::Node &bm_config) override {
     std::cout << "Setup " << _name << std::endl;
     if (bm_config["num_keys"]) {
@@ -73,12 +67,19 @@ class BinarySearch : public BaseBenchmark {
     if (bm_config["array_size"]) {
       array_size = bm_config["array_size"].as<int>();
     }
-    A = new int[array_size];
+    if (!arena.configure(bm_config)) {
+      return false;
+    }
+    A = arena.alloc<int>(array_size);
+    keys = arena.alloc<int>(num_keys);
+    if (!A || !keys) {
+      return false;
+    }
+    arena.record(bm_config);
     for (int i = 0; i < array_size; i++) {
       A[i] = std::rand() % 256;
       // printf("A[%d] = %d\n", i, A[i]);
     }
-    keys = new int[num_keys];
     for (int i = 0; i < num_keys; i++) {
       keys[i] = std::rand() % 256;
     }
@@ -108,6 +109,16 @@ class BinarySearch : public BaseBenchmark {
               << std::endl;
   }
 
+  void metrics(MetricSink &sink) override {
+    sink.counter("searches", num_keys, "searches");
+    sink.counter("found_keys", found_keys, "keys");
+    sink.rate("found_ratio", found_keys, num_keys);
+  }
+
+  double opCount() const override { return num_keys; }
+
+  std::string opUnit() const override { return "searches"; }
+
   int __attribute__((noinline)) Binary_search(int* x, int xsize, int target) {
     int maximum = xsize - 1;
     int minimum = 0;
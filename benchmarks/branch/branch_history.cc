@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Branch history length probe for TAGE-class predictors.
+ *
+ * `random-branch` draws a new random outcome in every iteration, which no
+ * predictor can learn. Here the outcomes repeat, and the predictor can
+ * only learn them if its global history reaches back far enough:
+ *
+ *  - `mode: period`: the test branch follows a random pattern of
+ *    `period` (P) outcomes that repeats. The misses per iteration drop
+ *    from ~0.5 to ~0 once the history covers P iterations.
+ *  - `mode: correlation`: a random source branch per iteration, and a
+ *    test branch with the outcome of the source branch `distance` (K)
+ *    iterations earlier. The source branch always misses half of the
+ *    time, the test branch only if the history does not reach K
+ *    iterations back (~1.0 vs ~0.5 misses per iteration).
+ *
+ * Every iteration is padded with a chain of `fillers` always-taken
+ * branches (a code blob, see utils/jit.hh), which stretches the history
+ * an iteration occupies. With F > 0 an iteration has the test (and
+ * source) branch, the F fillers, the call and return of the chain, its
+ * entry jump and the loop branch. Sweeping P or K for several F shows
+ * the longest global history the predictor exploits, e.g. the history
+ * lengths of `LTAGE_TAGE` and `TAGE_SC_L_64KB` in gem5.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmarks/base.hh"
+#include "benchmarks/registry.hh"
+#include "utils/jit.hh"
+#include "cond_branch.hh"
+#include "lfsr.h"
+
+class BranchHistory : public BaseBenchmark {
+ private:
+  int loop_count;
+  bool correlation;
+  int period;
+  int distance;
+  int fillers;
+  Lfsr32 lfsr;
+  CodeBlob blob;
+  // Outcomes of the source and the test branch of every iteration
+  std::vector<uint8_t> source;
+  std::vector<uint8_t> test;
+  uint64_t br_exec_count;
+  uint64_t br_not_taken_count;
+
+ public:
+  BranchHistory(std::string name)
+      : BaseBenchmark(name),
+        loop_count(10000),
+        correlation(false),
+        period(16),
+        distance(8),
+        fillers(0),
+        lfsr(0xA01),
+        br_exec_count(0),
+        br_not_taken_count(0)
+  {
+  }
+
+  ~BranchHistory() {}
+
+  bool init(YAML::Node &bm_config) override {
+    std::cout << "Setup " << _name << std::endl;
+    if (bm_config["loop_count"]) {
+      loop_count = bm_config["loop_count"].as<int>();
+    }
+    if (bm_config["mode"]) {
+      std::string mode = bm_config["mode"].as<std::string>();
+      if (mode != "period" && mode != "correlation") {
+        std::cerr << "Error: unknown mode " << mode
+                  << " (period, correlation)" << std::endl;
+        return false;
+      }
+      correlation = mode == "correlation";
+    }
+    if (bm_config["period"]) {
+      period = bm_config["period"].as<int>();
+    }
+    if (bm_config["distance"]) {
+      distance = bm_config["distance"].as<int>();
+    }
+    if (bm_config["fillers"]) {
+      fillers = bm_config["fillers"].as<int>();
+    }
+    if (loop_count <= 0 || period <= 0 || distance <= 0 || fillers < 0) {
+      std::cerr << "Error: loop_count, period and distance must be "
+                << "positive, fillers must not be negative." << std::endl;
+      return false;
+    }
+
+    if (fillers > 0) {
+      CodeBlob::Layout &l = blob.getLayout();
+      l.num_branches = fillers;
+      l.spacing = 16;
+      l.type = CodeBlob::Taken;
+      if (!blob.build()) {
+        return false;
+      }
+    }
+
+    // Draw all outcomes up front, exec() only loads them
+    source.resize(loop_count);
+    test.resize(loop_count);
+    // The first outputs are the bits of the seed, skip them
+    lfsr.reset();
+    for (int i = 0; i < 32; i++) {
+      lfsr.next();
+    }
+    std::vector<uint8_t> pattern(period);
+    int ones = 0;
+    for (auto &p : pattern) {
+      p = (lfsr.next() >> 3) & 1;
+      ones += p;
+    }
+    // A constant pattern needs no history
+    if (period > 1 && (ones == 0 || ones == period)) {
+      pattern.back() ^= 1;
+    }
+    for (int i = 0; i < loop_count; i++) {
+      source[i] = (lfsr.next() >> 3) & 1;
+      if (correlation) {
+        test[i] = i >= distance ? source[i - distance]
+                                : (lfsr.next() >> 3) & 1;
+      } else {
+        test[i] = pattern[i % period];
+      }
+    }
+    return true;
+  }
+
+  void exec() override {
+    const uint8_t *src = source.data();
+    const uint8_t *tst = test.data();
+    uint64_t not_taken = 0;
+    for (int i = 0; i < loop_count; i++) {
+      if (correlation) {
+        condBranch(src[i], not_taken);
+      }
+      condBranch(tst[i], not_taken);
+      if (fillers > 0) {
+        blob.run();
+      }
+    }
+    br_exec_count += (correlation ? 2 : 1) * (uint64_t)loop_count;
+    br_not_taken_count += not_taken;
+  }
+
+  void repeat() override {
+    br_exec_count = 0;
+    br_not_taken_count = 0;
+  }
+
+  void report() override {
+    if (correlation) {
+      std::cout << "Correlation distance: " << distance << " iterations"
+                << std::endl;
+    } else {
+      std::cout << "Period: " << period << " iterations" << std::endl;
+    }
+    std::cout << "Filler branches: " << fillers << std::endl;
+    std::cout << "Loop count: " << loop_count << std::endl;
+    std::cout << "Branch executed: " << br_exec_count << std::endl;
+    std::cout << "Branch taken: " << br_exec_count - br_not_taken_count
+              << std::endl;
+  }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("branch_executed", br_exec_count, "branches");
+    sink.counter("branch_taken", br_exec_count - br_not_taken_count,
+                 "branches");
+    sink.rate("taken_ratio", br_exec_count - br_not_taken_count,
+              br_exec_count);
+  }
+
+  double opCount() const override { return loop_count; }
+
+  std::string opUnit() const override { return "iterations"; }
+};
+
+
+REGISTER_BENCHMARK("branch-history", BranchHistory);
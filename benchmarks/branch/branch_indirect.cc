@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022 EASE Group, The University of Edinburgh
+ * Copyright (c) 2025 Technical University of Munich
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,109 +26,265 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-
-
-/** Simple stride benchmark
+/**
+ * @file
+ * Indirect branch predictor benchmark (e.g. ITTAGE).
+ *
+ * Every iteration executes `sites` (S) distinct indirect call sites in a
+ * row. Each site calls one of `targets` (T) functions through a function
+ * pointer table. The target of every site and iteration is drawn in
+ * init() according to `pattern`:
+ *
+ *  - `round_robin`: site s calls target (i + s) mod T in iteration i. A
+ *    BTB that predicts the last target misses every call if T > 1, a
+ *    predictor with target or path history learns the sequence.
+ *  - `random`: a random target per iteration, the same for all sites
+ *    but shifted by the site (r + s) mod T. The first site misses with
+ *    probability 1 - 1/T, the following ones can be predicted from the
+ *    targets of the previous sites.
+ *  - `history`: as `random`, but every iteration first executes
+ *    ceil(log2(T)) conditional branches on the bits of r. The target of
+ *    all sites can be predicted from the global history of conditional
+ *    branches.
  *
- * Description:
-*/
+ * The runner divides the time and the counters by the number of executed
+ * indirect calls (loop_count * S), i.e. `cycles_per_op` and
+ * `branch-misses_per_op` are the cycles and mispredicts per indirect
+ * branch. The null variant executes the same loop and the same loads
+ * without the calls.
+ *
+ * Only indirect calls are generated. Compilers lower a computed goto or
+ * a switch to a single shared jump or a compare chain, so distinct
+ * indirect jump sites are not reliably expressible in C++.
+ */
 
-#include "branch_test.hh"
-#include "util.hh"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
-// // This let the compiler know about the external assembly
-// extern "C" {
-// 	uint64_t singlestride(uint64_t* A, uint64_t stride, uint64_t num_iterations) __attribute__((sysv_abi));
-// }
+#include "benchmarks/base.hh"
+#include "benchmarks/registry.hh"
+#include "cond_branch.hh"
+#include "lfsr.h"
 
+static constexpr int max_targets = 64;
+static constexpr int max_sites = 32;
 
-BranchIndirect::BranchIndirect(uint64_t array_size)
-	: Benchmark("Branch: sorted data"),
-    A(nullptr),
-    array_size(array_size),
-	num_iterations(1),
-	ref_val(0), res_val(0)
+// The targets. Each returns a different value, so they cannot be folded
+// into one function.
+template <int J>
+__attribute__((noinline)) static uint64_t indirectTarget(uint64_t x)
 {
+  return x + J;
 }
 
-BranchIndirect::~BranchIndirect()
+typedef uint64_t (*Target)(uint64_t);
+
+template <size_t... J>
+static constexpr std::array<Target, sizeof...(J)> makeTargets(
+    std::index_sequence<J...>)
 {
-	delete A;
+  return {{&indirectTarget<J>...}};
 }
 
-bool BranchIndirect::init()
-{
-  	if (array_size == 0) {
-		std::cerr << "Array of size 0 makes no sense!" << std::endl;
-	}
+static constexpr std::array<Target, max_targets> targets_table =
+    makeTargets(std::make_index_sequence<max_targets>{});
 
-	fatal_if(!isPowerOf2(array_size), "Must be power of two!\n");
+class BranchIndirect : public BaseBenchmark {
+ private:
+  enum Pattern { RoundRobin, History, Random };
 
-	A = new uint64_t[array_size];
+  int loop_count;
+  int num_targets;
+  int num_sites;
+  Pattern pattern;
+  // Number of conditional branches per iteration (history pattern)
+  int num_bits;
+  Lfsr32 lfsr;
+  // Target of every site and iteration (loop_count * sites)
+  std::vector<uint8_t> sequence;
+  // Random selector of every iteration (history pattern)
+  std::vector<uint8_t> selector;
+  uint64_t result;
+  uint64_t ind_exec_count;
 
-	// Here we initialize the memory.
-    for (unsigned c = 0; c < array_size; ++c) {
-		auto v = std::rand() % 16;
-		ref_val += v;
-		A[c] = v;
-	}
+  // One iteration: the call sites of all sites. Every element of the
+  // fold expression is a separate call instruction.
+  template <size_t... I>
+  static inline uint64_t callSites(const uint8_t *seq, uint64_t acc,
+                                   std::index_sequence<I...>) {
+    ((acc = targets_table[seq[I]](acc)), ...);
+    return acc;
+  }
 
-	// std::sort(A, A + array_size);
+  template <size_t... I>
+  static inline uint64_t loadSites(const uint8_t *seq, uint64_t acc,
+                                   std::index_sequence<I...>) {
+    ((acc += seq[I]), ...);
+    return acc;
+  }
 
-	Benchmark::init();
-  	return true;
-}
+  template <int S>
+  void loop() {
+    const uint8_t *seq = sequence.data();
+    const uint8_t *sel = selector.data();
+    uint64_t acc = 0;
+    uint64_t not_taken = 0;
+    for (int i = 0; i < loop_count; i++, seq += S) {
+      for (int b = 0; b < num_bits; b++) {
+        condBranch((sel[i] >> b) & 1, not_taken);
+      }
+      if (null_variant) {
+        acc = loadSites(seq, acc, std::make_index_sequence<S>{});
+      } else {
+        acc = callSites(seq, acc, std::make_index_sequence<S>{});
+      }
+    }
+    doNotOptimize(not_taken);
+    result = acc;
+  }
+
+  typedef void (BranchIndirect::*Loop)();
+
+  template <size_t... S>
+  static constexpr std::array<Loop, sizeof...(S)> makeLoops(
+      std::index_sequence<S...>) {
+    return {{&BranchIndirect::loop<S + 1>...}};
+  }
+
+  // Random number of 8 bits. The outputs of the LFSR are shifted copies
+  // of each other, take a single bit of each.
+  uint8_t draw() {
+    uint8_t r = 0;
+    for (int b = 0; b < 8; b++) {
+      r = (r << 1) | ((lfsr.next() >> 3) & 1);
+    }
+    return r;
+  }
+
+ public:
+  BranchIndirect(std::string name)
+      : BaseBenchmark(name),
+        loop_count(10000),
+        num_targets(4),
+        num_sites(1),
+        pattern(RoundRobin),
+        num_bits(0),
+        lfsr(0xA01),
+        result(0),
+        ind_exec_count(0)
+  {
+  }
+
+  ~BranchIndirect() {}
+
+  bool init(YAML::Node &bm_config) override {
+    std::cout << "Setup " << _name << std::endl;
+    if (bm_config["loop_count"]) {
+      loop_count = bm_config["loop_count"].as<int>();
+    }
+    if (bm_config["targets"]) {
+      num_targets = bm_config["targets"].as<int>();
+    }
+    if (bm_config["sites"]) {
+      num_sites = bm_config["sites"].as<int>();
+    }
+    if (bm_config["pattern"]) {
+      std::string p = bm_config["pattern"].as<std::string>();
+      if (p == "round_robin") {
+        pattern = RoundRobin;
+      } else if (p == "history") {
+        pattern = History;
+      } else if (p == "random") {
+        pattern = Random;
+      } else {
+        std::cerr << "Error: unknown pattern " << p
+                  << " (round_robin, history, random)" << std::endl;
+        return false;
+      }
+    }
+    if (loop_count <= 0) {
+      std::cerr << "Error: loop_count must be positive." << std::endl;
+      return false;
+    }
+    if (num_targets < 1 || num_targets > max_targets) {
+      std::cerr << "Error: targets must be between 1 and " << max_targets
+                << "." << std::endl;
+      return false;
+    }
+    if (num_sites < 1 || num_sites > max_sites) {
+      std::cerr << "Error: sites must be between 1 and " << max_sites
+                << "." << std::endl;
+      return false;
+    }
+
+    num_bits = 0;
+    if (pattern == History) {
+      while ((1 << num_bits) < num_targets) {
+        num_bits++;
+      }
+    }
+
+    // Draw all targets up front, exec() only loads them
+    sequence.resize((size_t)loop_count * num_sites);
+    selector.assign(loop_count, 0);
+    // The first outputs are the bits of the seed, skip them
+    lfsr.reset();
+    for (int i = 0; i < 32; i++) {
+      lfsr.next();
+    }
+    for (int i = 0; i < loop_count; i++) {
+      int base = pattern == RoundRobin ? i % num_targets
+                                       : draw() % num_targets;
+      selector[i] = base;
+      for (int s = 0; s < num_sites; s++) {
+        sequence[(size_t)i * num_sites + s] = (base + s) % num_targets;
+      }
+    }
+    return true;
+  }
+
+  void exec() override {
+    static constexpr std::array<Loop, max_sites> loops =
+        makeLoops(std::make_index_sequence<max_sites>{});
+    (this->*loops[num_sites - 1])();
+    if (!null_variant) {
+      ind_exec_count += (uint64_t)loop_count * num_sites;
+    }
+  }
+
+  void repeat() override {
+    ind_exec_count = 0;
+  }
+
+  void report() override {
+    static const char *names[] = {"round_robin", "history", "random"};
+    std::cout << "Pattern: " << names[pattern] << std::endl;
+    std::cout << "Targets: " << num_targets << std::endl;
+    std::cout << "Sites: " << num_sites << std::endl;
+    std::cout << "Loop count: " << loop_count << std::endl;
+    std::cout << "Indirect branches executed: " << ind_exec_count
+              << std::endl;
+    std::cout << "Result: " << result << std::endl;
+  }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("indirect_executed", ind_exec_count, "branches");
+    sink.counter("cond_executed", (uint64_t)loop_count * num_bits,
+                 "branches");
+  }
+
+  bool hasNull() const override { return true; }
+
+  double opCount() const override {
+    return (double)loop_count * num_sites;
+  }
+
+  std::string opUnit() const override { return "indirect branches"; }
+};
 
-__attribute__((optimize("O0")))
-void BranchIndirect::exec()
-{
-	// Call the assembly
-	// res_val =  singlestride(A, stride, num_iterations);
-
-	for (unsigned i = 0; i < LOOP; ++i)
-	{
-		for (unsigned c = 0; c < array_size; ++c)
-		{
-			switch (A[c])
-			{
-			case 0:
-				res_val += 4;
-				break;
-
-			case 2:
-				res_val += 5;
-				break;
-
-			case 5:
-				res_val += 3;
-				continue;
-				break;
-			}
-
-
-			switch (A[c])
-			{
-			case 1:
-			case 9:
-				res_val += 4;
-				break;
-
-			case 6:
-				res_val += 5;
-				break;
-
-			case 5:
-				res_val += 3;
-				break;
-				res_val += 4;
-				break;
-
-			case 12:
-				res_val += 5;
-				continue;
-				break;
-			}
-		}
-	}
-}
 
+REGISTER_BENCHMARK("branch-indirect", BranchIndirect);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022 EASE Group, The University of Edinburgh
+ * Copyright (c) 2025 Technical University of Munich
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,107 +26,470 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+/**
+ * @file
+ * Return address stack (RAS) depth and corruption benchmark.
+ *
+ * Every iteration recurses to `depth` (D) and returns. Each level calls
+ * the next one from one of two call sites, chosen by a random bit per
+ * level that is the same in every iteration. The returns of one `ret`
+ * instruction therefore go to two different addresses, which only a RAS
+ * predicts. While D fits into the RAS all returns hit; beyond it the
+ * oldest entries are overwritten and about half of the outer D - RAS
+ * returns miss. Sweeping D shows the knee at the RAS size in
+ * `branch-misses_per_op`.
+ *
+ * `variant` selects how calls and returns are paired:
+ *
+ *  - `call`: matched call/ret pairs (D + 1 calls, D + 1 returns).
+ *  - `tail_call`: every level is entered with a jump that passes its
+ *    return address in the link register (x86: on the stack), as a tail
+ *    call that forwards a continuation. The returns have no matching
+ *    call and pop stale entries (1 call, D + 1 returns).
+ *  - `longjmp`: descends D levels with calls, then restores the stack
+ *    pointer (and link register) of the entry and returns to the caller
+ *    at once, like longjmp() out of a recursion (D + 1 calls, 1 return).
+ *  - `forward_call_without_ret`: D calls to the next instruction whose
+ *    return address is dropped, as in `plotting/chart-je.py` (D + 1
+ *    calls, 1 return).
+ *
+ * The recursions are written in assembly for every architecture, so
+ * the compiler cannot remove the recursion or turn calls into jumps.
+ * The runner divides time and counters by the levels (D + 1 per
+ * iteration).
+ */
 
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
 
-/** Simple stride benchmark
- *
- * Description:
-*/
+#include "benchmarks/base.hh"
+#include "benchmarks/registry.hh"
+#include "lfsr.h"
+
+// All functions take the depth and the call site (0 or 1) of every
+// level and only clobber caller saved registers.
+extern "C" {
+void ubench_ret_call(uint64_t depth, const uint8_t *sites);
+void ubench_ret_tail(uint64_t depth, const uint8_t *sites);
+void ubench_ret_longjmp(uint64_t depth, const uint8_t *sites);
+void ubench_ret_forward(uint64_t depth, const uint8_t *sites);
+}
 
-#include "branch_test.hh"
-#include "util.hh"
+#if defined(ARCH) && ARCH == X86_64
+asm(R"(
+  .pushsection .text
+  .globl ubench_ret_call
+  .hidden ubench_ret_call
+  .type ubench_ret_call, @function
+  .p2align 4
+ubench_ret_call:
+  test %rdi, %rdi
+  jz 2f
+  dec %rdi
+  cmpb $0, (%rsi,%rdi)
+  jne 1f
+  call ubench_ret_call
+  ret
+1:
+  call ubench_ret_call
+2:
+  ret
+  .size ubench_ret_call, .-ubench_ret_call
 
-// // This let the compiler know about the external assembly
-// extern "C" {
-// 	uint64_t singlestride(uint64_t* A, uint64_t stride, uint64_t num_iterations) __attribute__((sysv_abi));
-// }
+  .globl ubench_ret_tail
+  .hidden ubench_ret_tail
+  .type ubench_ret_tail, @function
+  .p2align 4
+ubench_ret_tail:
+  test %rdi, %rdi
+  jz 2f
+  dec %rdi
+  cmpb $0, (%rsi,%rdi)
+  jne 1f
+  lea 3f(%rip), %rax
+  push %rax
+  jmp ubench_ret_tail
+3:
+  ret
+1:
+  lea 2f(%rip), %rax
+  push %rax
+  jmp ubench_ret_tail
+2:
+  ret
+  .size ubench_ret_tail, .-ubench_ret_tail
 
+  .globl ubench_ret_longjmp
+  .hidden ubench_ret_longjmp
+  .type ubench_ret_longjmp, @function
+  .p2align 4
+ubench_ret_longjmp:
+  mov %rsp, %r8
+.Lret_longjmp_body:
+  test %rdi, %rdi
+  jz 2f
+  dec %rdi
+  cmpb $0, (%rsi,%rdi)
+  jne 1f
+  call .Lret_longjmp_body
+  ud2
+1:
+  call .Lret_longjmp_body
+  ud2
+2:
+  mov %r8, %rsp
+  ret
+  .size ubench_ret_longjmp, .-ubench_ret_longjmp
 
-BranchReturn::BranchReturn(uint64_t array_size)
-	: Benchmark("Branch: return address test"),
-    A(nullptr),
-    array_size(array_size),
-	num_iterations(1),
-	ref_val(0), res_val(0)
-{
-}
+  .globl ubench_ret_forward
+  .hidden ubench_ret_forward
+  .type ubench_ret_forward, @function
+  .p2align 4
+ubench_ret_forward:
+  test %rdi, %rdi
+  jz 2f
+1:
+  call 3f
+3:
+  add $8, %rsp
+  dec %rdi
+  jnz 1b
+2:
+  ret
+  .size ubench_ret_forward, .-ubench_ret_forward
+  .popsection
+)");
+#elif defined(ARCH) && ARCH == ARM64
+asm(R"(
+  .pushsection .text
+  .globl ubench_ret_call
+  .hidden ubench_ret_call
+  .type ubench_ret_call, %function
+  .p2align 4
+ubench_ret_call:
+  cbz x0, 2f
+  sub x0, x0, #1
+  stp x29, x30, [sp, #-16]!
+  ldrb w2, [x1, x0]
+  cbnz w2, 1f
+  bl ubench_ret_call
+  ldp x29, x30, [sp], #16
+  ret
+1:
+  bl ubench_ret_call
+  ldp x29, x30, [sp], #16
+2:
+  ret
+  .size ubench_ret_call, .-ubench_ret_call
 
-BranchReturn::~BranchReturn()
-{
-	delete A;
-}
+  .globl ubench_ret_tail
+  .hidden ubench_ret_tail
+  .type ubench_ret_tail, %function
+  .p2align 4
+ubench_ret_tail:
+  cbz x0, 2f
+  sub x0, x0, #1
+  stp x29, x30, [sp, #-16]!
+  ldrb w2, [x1, x0]
+  cbnz w2, 1f
+  adr x30, 3f
+  b ubench_ret_tail
+3:
+  ldp x29, x30, [sp], #16
+  ret
+1:
+  adr x30, 4f
+  b ubench_ret_tail
+4:
+  ldp x29, x30, [sp], #16
+2:
+  ret
+  .size ubench_ret_tail, .-ubench_ret_tail
 
-bool BranchReturn::init()
-{
-  	if (array_size == 0) {
-		std::cerr << "Array of size 0 makes no sense!" << std::endl;
-	}
+  .globl ubench_ret_longjmp
+  .hidden ubench_ret_longjmp
+  .type ubench_ret_longjmp, %function
+  .p2align 4
+ubench_ret_longjmp:
+  mov x9, sp
+  mov x10, x30
+.Lret_longjmp_body:
+  cbz x0, 2f
+  sub x0, x0, #1
+  stp x29, x30, [sp, #-16]!
+  ldrb w2, [x1, x0]
+  cbnz w2, 1f
+  bl .Lret_longjmp_body
+  brk #0
+1:
+  bl .Lret_longjmp_body
+  brk #0
+2:
+  mov sp, x9
+  mov x30, x10
+  ret
+  .size ubench_ret_longjmp, .-ubench_ret_longjmp
 
-	fatal_if(!isPowerOf2(array_size), "Must be power of two!\n");
+  .globl ubench_ret_forward
+  .hidden ubench_ret_forward
+  .type ubench_ret_forward, %function
+  .p2align 4
+ubench_ret_forward:
+  mov x10, x30
+  cbz x0, 2f
+1:
+  bl 3f
+3:
+  sub x0, x0, #1
+  cbnz x0, 1b
+2:
+  mov x30, x10
+  ret
+  .size ubench_ret_forward, .-ubench_ret_forward
+  .popsection
+)");
+#elif defined(ARCH) && ARCH == RISCV64
+asm(R"(
+  .pushsection .text
+  .globl ubench_ret_call
+  .hidden ubench_ret_call
+  .type ubench_ret_call, @function
+  .p2align 4
+ubench_ret_call:
+  beqz a0, 2f
+  addi a0, a0, -1
+  addi sp, sp, -16
+  sd ra, 8(sp)
+  add t0, a1, a0
+  lbu t0, 0(t0)
+  bnez t0, 1f
+  jal ra, ubench_ret_call
+  ld ra, 8(sp)
+  addi sp, sp, 16
+  ret
+1:
+  jal ra, ubench_ret_call
+  ld ra, 8(sp)
+  addi sp, sp, 16
+2:
+  ret
+  .size ubench_ret_call, .-ubench_ret_call
 
-	A = new uint64_t[array_size];
+  .globl ubench_ret_tail
+  .hidden ubench_ret_tail
+  .type ubench_ret_tail, @function
+  .p2align 4
+ubench_ret_tail:
+  beqz a0, 2f
+  addi a0, a0, -1
+  addi sp, sp, -16
+  sd ra, 8(sp)
+  add t0, a1, a0
+  lbu t0, 0(t0)
+  bnez t0, 1f
+  lla ra, 3f
+  j ubench_ret_tail
+3:
+  ld ra, 8(sp)
+  addi sp, sp, 16
+  ret
+1:
+  lla ra, 4f
+  j ubench_ret_tail
+4:
+  ld ra, 8(sp)
+  addi sp, sp, 16
+2:
+  ret
+  .size ubench_ret_tail, .-ubench_ret_tail
 
-	// Here we initialize the memory.
-    for (unsigned c = 0; c < array_size; ++c) {
-		auto v = std::rand() % 256;
-		ref_val += v;
-		A[c] = v;
-	}
+  .globl ubench_ret_longjmp
+  .hidden ubench_ret_longjmp
+  .type ubench_ret_longjmp, @function
+  .p2align 4
+ubench_ret_longjmp:
+  mv t1, sp
+  mv t2, ra
+.Lret_longjmp_body:
+  beqz a0, 2f
+  addi a0, a0, -1
+  addi sp, sp, -16
+  sd ra, 8(sp)
+  add t0, a1, a0
+  lbu t0, 0(t0)
+  bnez t0, 1f
+  jal ra, .Lret_longjmp_body
+  unimp
+1:
+  jal ra, .Lret_longjmp_body
+  unimp
+2:
+  mv sp, t1
+  mv ra, t2
+  ret
+  .size ubench_ret_longjmp, .-ubench_ret_longjmp
 
-	// std::sort(A, A + array_size);
+  .globl ubench_ret_forward
+  .hidden ubench_ret_forward
+  .type ubench_ret_forward, @function
+  .p2align 4
+ubench_ret_forward:
+  mv t2, ra
+  beqz a0, 2f
+1:
+  jal ra, 3f
+3:
+  addi a0, a0, -1
+  bnez a0, 1b
+2:
+  mv ra, t2
+  ret
+  .size ubench_ret_forward, .-ubench_ret_forward
+  .popsection
+)");
+#else
+#error "Unsupported architecture. Please define ARCH to X86_64, ARM64, or RISCV64."
+#endif
 
-	Benchmark::init();
-  	return true;
-}
+static constexpr int max_depth = 1 << 16;
 
-// void BranchReturn::exec()
-// {
-// 	// Call the assembly
-// 	// res_val =  singlestride(A, stride, num_iterations);
-
-// 	for (unsigned i = 0; i < LOOP; ++i)
-// 	{
-// 		for (unsigned c = 0; c < array_size; ++c)
-// 		{
-// 		if (A[c] >= 128)
-// 			res_val += A[c];
-// 		}
-// 	}
-// }
-
-void BranchReturn::exec()
-{
-	// Call the assembly
-	// res_val =  singlestride(A, stride, num_iterations);
-
-	for (unsigned i = 0; i < LOOP; ++i)
-	{
-
-		// for (unsigned c = 0; c < array_size; ++c)
-		// {
-		factorial(func2(10));
-		// }
-	}
-}
+class BranchReturn : public BaseBenchmark {
+ private:
+  enum Variant { Call, TailCall, Longjmp, Forward };
+
+  int loop_count;
+  int depth;
+  Variant variant;
+  Lfsr32 lfsr;
+  // Call site of every level
+  std::vector<uint8_t> sites;
+  uint64_t call_count;
+  uint64_t ret_count;
 
+ public:
+  BranchReturn(std::string name)
+      : BaseBenchmark(name),
+        loop_count(1000),
+        depth(16),
+        variant(Call),
+        lfsr(0xA01),
+        call_count(0),
+        ret_count(0)
+  {
+  }
 
+  ~BranchReturn() {}
 
-int
-BranchReturn::factorial(int n) {
-    if (n > 1) {
-        return n * factorial(n - 1);
-    } else {
-        return 1;
+  bool init(YAML::Node &bm_config) override {
+    std::cout << "Setup " << _name << std::endl;
+    if (bm_config["loop_count"]) {
+      loop_count = bm_config["loop_count"].as<int>();
+    }
+    if (bm_config["depth"]) {
+      depth = bm_config["depth"].as<int>();
+    }
+    if (bm_config["variant"]) {
+      std::string v = bm_config["variant"].as<std::string>();
+      if (v == "call") {
+        variant = Call;
+      } else if (v == "tail_call") {
+        variant = TailCall;
+      } else if (v == "longjmp") {
+        variant = Longjmp;
+      } else if (v == "forward_call_without_ret") {
+        variant = Forward;
+      } else {
+        std::cerr << "Error: unknown variant " << v
+                  << " (call, tail_call, longjmp, forward_call_without_ret)"
+                  << std::endl;
+        return false;
+      }
+    }
+    if (loop_count <= 0) {
+      std::cerr << "Error: loop_count must be positive." << std::endl;
+      return false;
+    }
+    if (depth < 0 || depth > max_depth) {
+      std::cerr << "Error: depth must be between 0 and " << max_depth
+                << "." << std::endl;
+      return false;
     }
-}
 
+    // The first outputs are the bits of the seed, skip them
+    sites.resize(depth + 1);
+    lfsr.reset();
+    for (int i = 0; i < 32; i++) {
+      lfsr.next();
+    }
+    for (auto &s : sites) {
+      s = (lfsr.next() >> 3) & 1;
+    }
+    return true;
+  }
 
-bool BranchReturn::check()
-{
-	// Call the assembly
-    std::cout << "Ref: " << ref_val << " Res: " << res_val << std::endl;
-	// return (ref_val == res_val) ? true : false;
-	return true;
-}
+  void exec() override {
+    const uint8_t *s = sites.data();
+    uint64_t d = depth;
+    switch (variant) {
+      case Call:
+        for (int i = 0; i < loop_count; i++) {
+          ubench_ret_call(d, s);
+        }
+        call_count += (d + 1) * loop_count;
+        ret_count += (d + 1) * loop_count;
+        break;
+      case TailCall:
+        for (int i = 0; i < loop_count; i++) {
+          ubench_ret_tail(d, s);
+        }
+        call_count += loop_count;
+        ret_count += (d + 1) * loop_count;
+        break;
+      case Longjmp:
+        for (int i = 0; i < loop_count; i++) {
+          ubench_ret_longjmp(d, s);
+        }
+        call_count += (d + 1) * loop_count;
+        ret_count += loop_count;
+        break;
+      case Forward:
+        for (int i = 0; i < loop_count; i++) {
+          ubench_ret_forward(d, s);
+        }
+        call_count += (d + 1) * loop_count;
+        ret_count += loop_count;
+        break;
+    }
+  }
+
+  void repeat() override {
+    call_count = 0;
+    ret_count = 0;
+  }
+
+  void report() override {
+    static const char *names[] = {"call", "tail_call", "longjmp",
+                                  "forward_call_without_ret"};
+    std::cout << "Variant: " << names[variant] << std::endl;
+    std::cout << "Depth: " << depth << std::endl;
+    std::cout << "Loop count: " << loop_count << std::endl;
+    std::cout << "Calls executed: " << call_count << std::endl;
+    std::cout << "Returns executed: " << ret_count << std::endl;
+  }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("calls_executed", call_count, "branches");
+    sink.counter("returns_executed", ret_count, "branches");
+  }
+
+  double opCount() const override {
+    return (double)loop_count * (depth + 1);
+  }
+
+  std::string opUnit() const override { return "levels"; }
+};
 
 
+REGISTER_BENCHMARK("branch-return", BranchReturn);
@@ -62,69 +62,6 @@ public:
 
 
 
-class BranchIndirect : public Benchmark
-{
-private:
-  /* The arrays*/
-  uint64_t *A;
-  uint64_t array_size;
-  uint64_t ref_val;
-  uint64_t res_val;
-
-
-
-public:
-  uint64_t num_iterations;
-
-  BranchIndirect(uint64_t ARRAYSIZE);
-  ~BranchIndirect();
-
-  bool init() override;
-  void exec() override;
-  bool check();
-};
-
-
-
-
-class BranchReturn : public Benchmark
-{
-private:
-  /* The arrays*/
-  uint64_t *A;
-  uint64_t array_size;
-  uint64_t ref_val;
-  uint64_t res_val;
-
-
-  __attribute__((optimize("O0")))
-  int func1(int n) {
-    return n;
-  }
-
-  __attribute__((optimize("O0")))
-  int func2(int n) {
-    return func1(n);
-  }
-
-int factorial(int);
-
-public:
-  uint64_t num_iterations;
-
-  BranchReturn(uint64_t ARRAYSIZE);
-  ~BranchReturn();
-
-  bool init() override;
-  void exec() override;
-  bool check();
-};
-
-
-
-
-
-
 class BranchBTB : public Benchmark
 {
 private:
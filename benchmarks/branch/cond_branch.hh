@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A conditional branch in inline assembly for benchmarks that need a real
+ * branch on a data bit.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "benchmarks/base.hh"
+
+// A conditional branch on `bit` that the compiler cannot turn into a
+// conditional move. Taken if bit is non-zero, counts the not taken ones.
+static inline void condBranch(uint64_t bit, uint64_t &not_taken)
+{
+#if defined(ARCH) && ARCH == X86_64
+  asm volatile("test %1, %1\n\t"
+               "jnz 1f\n\t"
+               "add $1, %0\n"
+               "1:\n"
+               : "+r"(not_taken) : "r"(bit) : "cc");
+#elif defined(ARCH) && ARCH == ARM64
+  asm volatile("cbnz %1, 1f\n\t"
+               "add %0, %0, #1\n"
+               "1:\n"
+               : "+r"(not_taken) : "r"(bit));
+#elif defined(ARCH) && ARCH == RISCV64
+  asm volatile("bnez %1, 1f\n\t"
+               "addi %0, %0, 1\n"
+               "1:\n"
+               : "+r"(not_taken) : "r"(bit));
+#else
+#error "Unsupported architecture. Please define ARCH to X86_64, ARM64, or RISCV64."
+#endif
+}
@@ -37,6 +37,7 @@
 
 #include "benchmarks/base.hh"
 #include "benchmarks/registry.hh"
+#include "cond_branch.hh"
 #include "lfsr.h"
 
 class RandomBranch : public BaseBenchmark {
@@ -67,14 +68,29 @@ class RandomBranch : public BaseBenchmark {
   }
 
   void exec() override {
-    for (int i = 0; i < loop_count; i++) {
-      auto val = lfsr.next();
-      if ((val >> 3) % 2 == 0) {
-        // Simulate a branch taken
-        br_taken_count++;
+    // Both variants keep the state in locals (registers)
+    Lfsr32 rng = lfsr;
+    int executed = 0;
+    uint64_t taken = 0;
+    if (null_variant) {
+      // Same LFSR sequence, no data dependent branch
+      for (int i = 0; i < loop_count; i++) {
+        auto val = rng.next();
+        doNotOptimize(val);
+        executed++;
+      }
+    } else {
+      for (int i = 0; i < loop_count; i++) {
+        auto val = rng.next();
+        // A real branch, the compiler turns an if into a conditional add.
+        // The fall-through path (bit 3 clear) counts as taken.
+        condBranch((val >> 3) & 1, taken);
+        executed++;
       }
-      br_exec_count++;
     }
+    lfsr = rng;
+    br_exec_count += executed;
+    br_taken_count += taken;
   }
 
   void repeat() override {
@@ -90,6 +106,18 @@ class RandomBranch : public BaseBenchmark {
     std::cout << "Branch not taken: " << br_exec_count - br_taken_count
               << std::endl;
   }
+
+  bool hasNull() const override { return true; }
+
+  double opCount() const override { return loop_count; }
+
+  std::string opUnit() const override { return "branches"; }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("branch_executed", br_exec_count, "branches");
+    sink.counter("branch_taken", br_taken_count, "branches");
+    sink.rate("taken_ratio", br_taken_count, br_exec_count);
+  }
 };
 
 
@@ -37,7 +37,9 @@
 
 #include "benchmarks/base.hh"
 #include "benchmarks/registry.hh"
+#include "cond_branch.hh"
 #include "lfsr.h"
+#include "utils/memory.hh"
 
 class RandomBranchArray : public BaseBenchmark {
  private:
@@ -47,6 +49,7 @@ class RandomBranchArray : public BaseBenchmark {
   int br_taken_count;
   uint8_t *A;
   Lfsr32 lfsr;
+  Arena arena;
 
  public:
   RandomBranchArray(std::string name) 
@@ -57,12 +60,6 @@ class RandomBranchArray : public BaseBenchmark {
         lfsr(0xA01)  // Initialize LFSR with a seed
   {}
 
-  ~RandomBranchArray() {
-    if (A) {
-      delete A;
-    }
-  }
-
   bool init(YAML::Node &bm_config) override {
     std::cout << "Setup " << _name << std::endl;
     if (bm_config["array_size"]) {
@@ -76,7 +73,14 @@ class RandomBranchArray : public BaseBenchmark {
 
     
     lfsr.reset();
-    A = new uint8_t[array_size];
+    if (!arena.configure(bm_config)) {
+      return false;
+    }
+    A = arena.alloc<uint8_t>(array_size);
+    if (!A) {
+      return false;
+    }
+    arena.record(bm_config);
     for (int i = 0; i < array_size; i+=array_step) {
       auto val = lfsr.next();
       A[i] = uint8_t((val >> 3) % 2);
@@ -85,14 +89,27 @@ class RandomBranchArray : public BaseBenchmark {
   }
 
   void exec() override {
-    for (int i = 0; i < array_size; i+=array_step) {
-      auto v = A[i];
-      if (v == 0) {
-        // Simulate a branch taken
-        br_taken_count++;
+    // Both variants keep the counters in locals (registers)
+    int executed = 0;
+    uint64_t taken = 0;
+    if (null_variant) {
+      // Same loads, no data dependent branch
+      for (int i = 0; i < array_size; i+=array_step) {
+        auto v = A[i];
+        doNotOptimize(v);
+        executed++;
+      }
+    } else {
+      for (int i = 0; i < array_size; i+=array_step) {
+        auto v = A[i];
+        // A real branch, the compiler turns an if into a conditional add.
+        // The fall-through path (v == 0) counts as taken.
+        condBranch(v, taken);
+        executed++;
       }
-      br_exec_count++;
     }
+    br_exec_count += executed;
+    br_taken_count += taken;
   }
 
   void repeat() override {
@@ -108,6 +125,20 @@ class RandomBranchArray : public BaseBenchmark {
     std::cout << "Branch not taken: " << br_exec_count - br_taken_count
               << std::endl;
   }
+
+  bool hasNull() const override { return true; }
+
+  double opCount() const override {
+    return (array_size + array_step - 1) / array_step;
+  }
+
+  std::string opUnit() const override { return "branches"; }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("branch_executed", br_exec_count, "branches");
+    sink.counter("branch_taken", br_taken_count, "branches");
+    sink.rate("taken_ratio", br_taken_count, br_exec_count);
+  }
 };
 
 
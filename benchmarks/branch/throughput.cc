@@ -93,6 +93,16 @@ class RandomThroughput : public BaseBenchmark {
   void report() override {
     std::cout << "Loop count: " << loop_count << std::endl;
   }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("loop_count", loop_count, "iterations");
+  }
+
+  // Only the arm64 kernel has branches, count iterations on all
+  // architectures to compare them
+  double opCount() const override { return loop_count; }
+
+  std::string opUnit() const override { return "iterations"; }
 };
 
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * BTB set-conflict and associativity probe.
+ *
+ * Places `num_branches` taken branches at a power-of-two `stride` in a
+ * code blob (see utils/jit.hh) and runs the chain in a loop. Branches
+ * whose PCs only differ in bits at or above log2(stride) alias into the
+ * same BTB set if the BTB is indexed with lower bits. As long as the
+ * branches fit into the ways of the set every branch hits; one more
+ * branch and the chain misses on every branch (LRU), which shows up as a
+ * jump in the cycles, resteers or mispredicts per branch.
+ *
+ * Sweeping `num_branches` and `stride` reveals:
+ *  - the ways: the largest N without misses at a conflicting stride,
+ *  - the index bits: the smallest stride at which N > ways branches
+ *    conflict (the strides below spread over several sets),
+ *  - the sets: the total capacity divided by the ways.
+ *
+ * Large strides also map the branches to the same I-cache set and to
+ * different pages, so compare with the `frontend` counters.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "benchmarks/base.hh"
+#include "benchmarks/registry.hh"
+#include "utils/jit.hh"
+
+
+class BTBConflict : public BaseBenchmark {
+ private:
+  int loop_count;
+  int64_t stride;
+  CodeBlob blob;
+  int64_t br_executed;
+  // Branches executed by the last exec()
+  int64_t exec_branches;
+
+ public:
+  BTBConflict(std::string name)
+      : BaseBenchmark(name),
+        loop_count(1000),
+        stride(4096),
+        br_executed(0),
+        exec_branches(0)
+  {
+    blob.getLayout().num_branches = 8;
+  }
+
+  ~BTBConflict() {}
+
+  bool init(YAML::Node &bm_config) override {
+    std::cout << "Setup " << _name << std::endl;
+    if (bm_config["loop_count"]) {
+      loop_count = bm_config["loop_count"].as<int>();
+    }
+    if (bm_config["stride"] &&
+        !parseSize(bm_config["stride"].as<std::string>(), stride)) {
+      std::cerr << "Error: invalid stride." << std::endl;
+      return false;
+    }
+    if (stride <= 0 || (stride & (stride - 1)) != 0) {
+      std::cerr << "Error: stride must be a power of two." << std::endl;
+      return false;
+    }
+    // The stride sets the spacing, and never taken branches do not
+    // allocate BTB entries
+    if (bm_config["branch_spacing"]) {
+      std::cerr << "Error: use stride instead of branch_spacing."
+                << std::endl;
+      return false;
+    }
+    if (!blob.configure(bm_config)) {
+      return false;
+    }
+    if (blob.getLayout().type == CodeBlob::NotTaken) {
+      std::cerr << "Error: branch_type must be jump or taken."
+                << std::endl;
+      return false;
+    }
+    blob.getLayout().spacing = stride;
+    return blob.build();
+  }
+
+  void exec() override {
+    int64_t executed = 0;
+    for (int i = 0; i < loop_count; i++) {
+      executed += blob.run();
+    }
+    br_executed += executed;
+    exec_branches = executed;
+  }
+
+  void repeat() override {
+  }
+
+  void report() override {
+    const CodeBlob::Layout &l = blob.getLayout();
+    std::cout << "Executed " << l.num_branches << " "
+              << CodeBlob::name(l.type) << " branches at a stride of "
+              << stride << " bytes (offset " << l.offset << ")"
+              << std::endl;
+    std::cout << "Loop count: " << loop_count << std::endl;
+    std::cout << "Total branch executed: " << br_executed << std::endl;
+  }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("num_branches", blob.getLayout().num_branches, "branches");
+    sink.counter("stride", stride, "bytes");
+  }
+
+  double opCount() const override { return exec_branches; }
+
+  std::string opUnit() const override { return "branches"; }
+};
+
+
+REGISTER_BENCHMARK("btb-conflict", BTBConflict);
@@ -53,6 +53,8 @@ class BTBStress : public BaseBenchmark {
   std::string num_branches_str;
   int num_branches;
   int br_executed;
+  // Branches executed by the last exec()
+  int exec_branches;
 
  public:
  BTBStress(std::string name)
@@ -60,7 +62,8 @@ class BTBStress : public BaseBenchmark {
         loop_count(1),
         num_branches_str("2"),
         num_branches(2),
-        br_executed(0)
+        br_executed(0),
+        exec_branches(0)
   {
   }
 
@@ -101,9 +104,12 @@ class BTBStress : public BaseBenchmark {
 
   // Execute the benchmark
   void exec() override {
+    int executed = 0;
     for (int i = 0; i < loop_count; i++) {
-      br_executed += scramble_btb(num_branches);
+      executed += scramble_btb(num_branches);
     }
+    br_executed += executed;
+    exec_branches = executed;
   }
 
   void repeat() override {
@@ -115,6 +121,15 @@ class BTBStress : public BaseBenchmark {
     std::cout << "Loop count: " << loop_count << std::endl;
     std::cout << "Total branch executed: " << br_executed << std::endl;
   }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("num_branches", num_branches, "branches");
+    sink.counter("branch_executed", exec_branches, "branches");
+  }
+
+  double opCount() const override { return exec_branches; }
+
+  std::string opUnit() const override { return "branches"; }
 };
 
 
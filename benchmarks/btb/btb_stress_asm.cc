@@ -53,6 +53,8 @@ class BTBStressASM : public BaseBenchmark {
   std::string num_branches_str;
   int num_branches;
   int br_executed;
+  // Branches executed by the last exec()
+  int exec_branches;
 
   std::function<int()> scramble_func;
   std::map<std::string, std::function<int()>> scramble_func_map = {
@@ -79,6 +81,7 @@ class BTBStressASM : public BaseBenchmark {
         num_branches_str("2"),
         num_branches(2),
         br_executed(0),
+        exec_branches(0),
         scramble_func(nullptr)
   {
 
@@ -125,9 +128,12 @@ class BTBStressASM : public BaseBenchmark {
   }
 
   void exec() override {
+    int executed = 0;
     for (int i = 0; i < loop_count; i++) {
-      br_executed += scramble_func();
+      executed += scramble_func();
     }
+    br_executed += executed;
+    exec_branches = executed;
   }
 
   void repeat() override {
@@ -139,6 +145,15 @@ class BTBStressASM : public BaseBenchmark {
     std::cout << "Loop count: " << loop_count << std::endl;
     std::cout << "Total branch executed: " << br_executed << std::endl;
   }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("num_branches", num_branches, "branches");
+    sink.counter("branch_executed", exec_branches, "branches");
+  }
+
+  double opCount() const override { return exec_branches; }
+
+  std::string opUnit() const override { return "branches"; }
 };
 
 
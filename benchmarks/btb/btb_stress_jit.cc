@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * BTB stress benchmark with a branch chain generated at runtime.
+ * Unlike `btb-stress` and `btb-stress-asm`, whose branches are generated
+ * at build time for a fixed set of sizes, the chain is emitted into a
+ * code blob in init(). Any number of branches, spacing, offset and
+ * branch type can be configured (see utils/jit.hh).
+ */
+
+#include <iostream>
+#include <string>
+
+#include "benchmarks/base.hh"
+#include "benchmarks/registry.hh"
+#include "utils/jit.hh"
+
+
+class BTBStressJIT : public BaseBenchmark {
+ private:
+  int loop_count;
+  CodeBlob blob;
+  int64_t br_executed;
+  // Branches executed by the last exec()
+  int64_t exec_branches;
+
+ public:
+  BTBStressJIT(std::string name)
+      : BaseBenchmark(name),
+        loop_count(1),
+        br_executed(0),
+        exec_branches(0)
+  {
+  }
+
+  ~BTBStressJIT() {}
+
+  bool init(YAML::Node &bm_config) override {
+    std::cout << "Setup " << _name << std::endl;
+    if (bm_config["loop_count"]) {
+      loop_count = bm_config["loop_count"].as<int>();
+    }
+    if (!blob.configure(bm_config)) {
+      return false;
+    }
+    return blob.build();
+  }
+
+  void exec() override {
+    int64_t executed = 0;
+    for (int i = 0; i < loop_count; i++) {
+      executed += blob.run();
+    }
+    br_executed += executed;
+    exec_branches = executed;
+  }
+
+  void repeat() override {
+  }
+
+  void report() override {
+    const CodeBlob::Layout &l = blob.getLayout();
+    std::cout << "Executed code blob with " << l.num_branches << " "
+              << CodeBlob::name(l.type) << " branches, spacing "
+              << l.spacing << " bytes, offset " << l.offset << std::endl;
+    std::cout << "Blob size: " << blob.getSize() << " bytes" << std::endl;
+    std::cout << "Loop count: " << loop_count << std::endl;
+    std::cout << "Total branch executed: " << br_executed << std::endl;
+  }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("num_branches", blob.getLayout().num_branches, "branches");
+    sink.counter("branch_executed", exec_branches, "branches");
+  }
+
+  double opCount() const override { return exec_branches; }
+
+  std::string opUnit() const override { return "branches"; }
+};
+
+
+REGISTER_BENCHMARK("btb-stress-jit", BTBStressJIT);
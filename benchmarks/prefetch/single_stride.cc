@@ -37,6 +37,7 @@
 
 #include "benchmarks/base.hh"
 #include "benchmarks/registry.hh"
+#include "utils/memory.hh"
 
 class PrefetchStride : public BaseBenchmark {
  private:
@@ -44,6 +45,7 @@ class PrefetchStride : public BaseBenchmark {
   int stride;
   uint8_t *A;
   int results;
+  Arena arena;
 
  public:
   PrefetchStride(std::string name)
@@ -53,12 +55,6 @@ class PrefetchStride : public BaseBenchmark {
         A(nullptr)
   {}
 
-  ~PrefetchStride() {
-    if (A) {
-      delete A;
-    }
-  }
-
   bool init(YAML::Node &bm_config) override {
     std::cout << "Setup " << _name << std::endl;
     if (bm_config["array_size"]) {
@@ -74,8 +70,15 @@ class PrefetchStride : public BaseBenchmark {
 		std::cerr << "Stride of size 0 makes no sens!" << std::endl;
 	}
 
+    if (!arena.configure(bm_config)) {
+      return false;
+    }
     int v = 1;
-    A = new uint8_t[array_size];
+    A = arena.alloc<uint8_t>(array_size);
+    if (!A) {
+      return false;
+    }
+    arena.record(bm_config);
     for (int i = 0; i < array_size; i++) {
       A[i] = v;
     }
@@ -84,6 +87,13 @@ class PrefetchStride : public BaseBenchmark {
   }
 
   void exec() override {
+    if (null_variant) {
+      // Same loop, no load
+      for (int i = 0; i < array_size; i+=stride) {
+        doNotOptimize(i);
+      }
+      return;
+    }
 	int v = 0;
     for (int i = 0; i < array_size; i+=stride) {
       v += A[i];
@@ -99,6 +109,19 @@ class PrefetchStride : public BaseBenchmark {
     std::cout << "Array size: " << array_size << std::endl;
     std::cout << "Result: " << results << std::endl;
   }
+
+  bool hasNull() const override { return true; }
+
+  double opCount() const override {
+    return stride > 0 ? (array_size + stride - 1) / stride : 0;
+  }
+
+  std::string opUnit() const override { return "loads"; }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("accesses", opCount(), "loads");
+    sink.counter("result", results);
+  }
 };
 
 REGISTER_BENCHMARK("prefetch-stride", PrefetchStride);
\ No newline at end of file
@@ -72,6 +72,14 @@ class SimpleLoop : public BaseBenchmark {
     std::cout << "Loop count: " << loop_count << std::endl;
     std::cout << "Sum: " << sum << std::endl;
   }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("loop_count", loop_count, "iterations");
+  }
+
+  double opCount() const override { return loop_count; }
+
+  std::string opUnit() const override { return "iterations"; }
 };
 
 REGISTER_BENCHMARK("simple-loop", SimpleLoop);
\ No newline at end of file
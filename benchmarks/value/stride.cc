@@ -37,6 +37,7 @@
 
 #include "benchmarks/base.hh"
 #include "benchmarks/registry.hh"
+#include "utils/memory.hh"
 
 class ValueStride : public BaseBenchmark {
  private:
@@ -46,6 +47,7 @@ class ValueStride : public BaseBenchmark {
   int stride;
   int *A;
   int results;
+  Arena arena;
 
  public:
   ValueStride(std::string name)
@@ -57,12 +59,6 @@ class ValueStride : public BaseBenchmark {
         A(nullptr)
   {}
 
-  ~ValueStride() {
-    if (A) {
-      delete A;
-    }
-  }
-
   bool init(YAML::Node &bm_config) override {
     std::cout << "Setup " << _name << std::endl;
     if (bm_config["loop_count"]) {
@@ -77,8 +73,15 @@ class ValueStride : public BaseBenchmark {
     if (bm_config["array_step"]) {
       array_step = bm_config["array_step"].as<int>();
     }
+    if (!arena.configure(bm_config)) {
+      return false;
+    }
     int v = 0;
-    A = new int[array_size];
+    A = arena.alloc<int>(array_size);
+    if (!A) {
+      return false;
+    }
+    arena.record(bm_config);
     for (int i = 0; i < array_size; i+=array_step) {
       A[i] = v;
       v += stride;
@@ -88,6 +91,13 @@ class ValueStride : public BaseBenchmark {
   }
 
   void exec() override {
+    if (null_variant) {
+      // Same loop, no load
+      for (int i = 0; i < array_size; i+=array_step) {
+        doNotOptimize(i);
+      }
+      return;
+    }
     for (int i = 0; i < array_size; i+=array_step) {
       int v = A[i];
       results += v;
@@ -102,6 +112,19 @@ class ValueStride : public BaseBenchmark {
     std::cout << "Array size: " << array_size << std::endl;
     std::cout << "Result: " << results << std::endl;
   }
+
+  bool hasNull() const override { return true; }
+
+  double opCount() const override {
+    return (array_size + array_step - 1) / array_step;
+  }
+
+  std::string opUnit() const override { return "loads"; }
+
+  void metrics(MetricSink &sink) override {
+    sink.counter("accesses", opCount(), "loads");
+    sink.counter("result", results);
+  }
 };
 
 
@@ -0,0 +1,213 @@
+# Copyright (c) 2025 Technical University of Munich
+# All rights reserved.
+#
+# The license below extends only to copyright in the software and shall
+# not be construed as granting a license to any other intellectual
+# property including but not limited to intellectual property relating
+# to a hardware implementation of the functionality of the software
+# licensed hereunder.  You may use the software subject to the license
+# terms below provided that you ensure that this notice is replicated
+# unmodified and in its entirety in all distributions of the software,
+# modified or unmodified, in source code or in binary form.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+gem5 configuration script to run a multi-threaded binary in syscall
+emulation mode on N cores. Every core has private L1 and L2 caches, the
+L2s share an L3 through a coherent crossbar (GNRCacheHierarchy), so
+coherence traffic, false sharing and the bandwidth of the shared levels
+are simulated.
+
+`ubench --threads <T>` runs a copy of the benchmark on each of T threads,
+which gem5 places on the idle cores. With `--m5ops` every thread tags its
+work item with its thread ID. The stats are reset at the first begin and
+dumped at the last end of the work items of a repeat, so each dump covers
+the repeat on all cores.
+
+Usage:
+  ./build/<ISA>/gem5.opt se-multicore.py [--num-cores N] [--cpu-type o3] \
+      <BINARY_PATH> --threads <N> --m5ops <ARGS> ...
+
+Example: four copies of the random branch benchmark on four O3 cores.
+  ./build/X86/gem5.opt se-multicore.py --isa X86 --num-cores 4 \
+      --cpu-type o3 build-x64/ubench --config configs/random_branch.yaml \
+      --threads 4 --m5ops --repeats 5
+
+"""
+
+import argparse
+
+import m5
+
+from gem5.isas import ISA
+from gem5.utils.requires import requires
+from gem5.resources.resource import BinaryResource
+from gem5.components.memory import DualChannelDDR4_2400
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.processors.simple_processor import SimpleProcessor
+from gem5.simulate.simulator import Simulator
+from gem5.simulate.exit_event import ExitEvent
+
+from util.bp_configs import make_branch_pred
+from util.cache_configs import GNRCacheHierarchy
+
+
+isa_choices = {
+    "X86": ISA.X86,
+    "Arm": ISA.ARM,
+    "RiscV": ISA.RISCV,
+}
+
+cpu_types = {
+    "atomic": CPUTypes.ATOMIC,
+    "timing": CPUTypes.TIMING,
+    "o3": CPUTypes.O3,
+}
+
+parser = argparse.ArgumentParser(
+    description="Run a multi-threaded binary in system call emulation on "
+    "several cores with a shared L3"
+)
+
+parser.add_argument(
+    "--isa",
+    type=str,
+    default="X86",
+    help="The ISA to simulate.",
+    choices=isa_choices.keys(),
+)
+
+parser.add_argument(
+    "--cpu-type",
+    type=str,
+    default="atomic",
+    help="The CPU model to use.",
+    choices=cpu_types.keys(),
+)
+
+parser.add_argument(
+    "--num-cores",
+    type=int,
+    default=4,
+    help="Number of cores.",
+)
+
+parser.add_argument(
+    "--threads",
+    type=int,
+    default=None,
+    help="Threads that tag work items per repeat (ubench --threads). "
+    "Defaults to the number of cores.",
+)
+
+parser.add_argument(
+    "--l3-size",
+    type=str,
+    default=None,
+    help="Size of the shared L3 (default: 8MiB).",
+)
+
+parser.add_argument("cmd", nargs=argparse.REMAINDER)
+
+args = parser.parse_args()
+
+threads = args.threads if args.threads else args.num_cores
+if threads > args.num_cores:
+    parser.error("--threads must not exceed --num-cores")
+
+
+# This check ensures the gem5 binary is compiled to the correct ISA target.
+# If not, an exception will be thrown.
+requires(isa_required=isa_choices[args.isa])
+
+processor = SimpleProcessor(
+    cpu_type=cpu_types[args.cpu_type],
+    isa=isa_choices[args.isa],
+    num_cores=args.num_cores,
+)
+
+# Every core gets its own predictor
+for core in processor.cores:
+    core.get_simobject().branchPred = make_branch_pred()
+
+
+print(
+    "Running {} on {} {} CPUs: {}".format(
+        args.isa, args.num_cores, args.cpu_type, args.cmd
+    )
+)
+
+board = SimpleBoard(
+    clk_freq="3GHz",
+    processor=processor,
+    memory=DualChannelDDR4_2400(size="3GiB"),
+    cache_hierarchy=GNRCacheHierarchy(l3_size=args.l3_size),
+)
+
+board.set_se_binary_workload(
+    binary=BinaryResource(args.cmd[0]),
+    arguments=args.cmd[1:],
+)
+
+# Each of the threads begins and ends its own work item of a repeat. The
+# first begin resets the stats and the last end dumps them, such that the
+# dump covers the repeat from the start of the first to the end of the
+# last thread. The work items are counted, as a short repeat of one thread
+# may end before another thread began.
+def workbegin():
+    cnt = 0
+    while True:
+        if cnt % threads == 0:
+            print("Begin Repetition ", cnt // threads + 1)
+            m5.stats.reset()
+        cnt += 1
+        yield False
+
+
+def workend():
+    cnt = 0
+    while True:
+        cnt += 1
+        if cnt % threads == 0:
+            print("End Repetition ", cnt // threads)
+            m5.stats.dump()
+        yield False
+
+
+simulator = Simulator(
+    board=board,
+    on_exit_event={
+        ExitEvent.WORKBEGIN: workbegin(),
+        ExitEvent.WORKEND: workend(),
+        },
+)
+simulator.run()
+
+print(
+    "Exiting @ tick {} because {}.".format(
+        simulator.get_current_tick(), simulator.get_last_exit_event_cause()
+    )
+)
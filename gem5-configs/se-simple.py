@@ -38,9 +38,19 @@
 Simple gem5 configuration script to run a binary in syscall emulation mode.
 Usage: ./build/<ISA>/gem5.opt se-imple.py <BINARY_PATH> <ARG1> <ARG2> ...
 
+To skip the setup of the benchmark in detailed simulations, run `ubench`
+with `--m5-checkpoint` once with the atomic CPU and `--checkpoint <DIR>`.
+All detailed runs then start with `--restore <DIR>` from the point after
+`init()`:
+
+  gem5.opt se-simple.py --checkpoint cpt ubench -c <CONFIG> --m5-checkpoint
+  gem5.opt se-simple.py --restore cpt --cpu-type o3 ubench -c <CONFIG> --m5-checkpoint
+
 """
 
 import argparse
+from pathlib import Path
+
 import m5
 
 from gem5.isas import ISA
@@ -57,6 +67,8 @@ from gem5.components.processors.simple_processor import SimpleProcessor
 from gem5.simulate.simulator import Simulator
 from gem5.simulate.exit_event import ExitEvent
 
+from util.bp_configs import make_branch_pred
+
 
 isa_choices = {
     "X86": ISA.X86,
@@ -92,6 +104,28 @@ parser.add_argument(
     choices=cpu_types.keys(),
 )
 
+parser.add_argument(
+    "--checkpoint",
+    type=str,
+    default=None,
+    help="Save a checkpoint to this directory when the benchmark calls "
+    "m5_checkpoint (ubench --m5-checkpoint) and exit.",
+)
+
+parser.add_argument(
+    "--restore",
+    type=str,
+    default=None,
+    help="Restore the simulation from this checkpoint directory.",
+)
+
+
+parser.add_argument(
+    "--ittage",
+    action="store_true",
+    help="Predict indirect branches with ITTAGE instead of the default "
+    "indirect predictor (e.g. for branch-indirect).",
+)
 
 parser.add_argument("cmd", nargs=argparse.REMAINDER)
 
@@ -121,28 +155,7 @@ tage_bp = False
 tage_bp = True
 
 if tage_bp:
-    from m5.objects import (
-        SimpleBTB,
-        ITTAGE,
-        LTAGE,
-        LTAGE_TAGE,
-        TAGE_SC_L_TAGE_64KB,
-    )
-    class BTB(SimpleBTB):
-        numEntries = 16*1024
-        # associativity = 4
-        associativity = 8
-
-
-    class BPTageSCL(LTAGE):
-        instShiftAmt = 2
-        btb = BTB()
-        # tage = TAGE_SC_L_TAGE_64KB()
-        tage = LTAGE_TAGE()
-        requiresBTBHit = True
-
-
-    cpu.branchPred = BPTageSCL()
+    cpu.branchPred = make_branch_pred(ittage=args.ittage)
 
 
 
@@ -164,10 +177,12 @@ board = SimpleBoard(
 )
 
 
-# Here we set the workload.
+# Here we set the workload. The arguments must be the same as the ones
+# the checkpoint was taken with.
 board.set_se_binary_workload(
     binary=BinaryResource(args.cmd[0]),
     arguments=args.cmd[1:],
+    checkpoint=Path(args.restore) if args.restore else None,
 )
 
 # This function will be called at the beginning and end of each
@@ -188,6 +203,18 @@ def workitems(start) -> bool:
         yield False
 
 
+# This function will be called when the benchmark calls m5_checkpoint
+# after its setup (when the `--m5-checkpoint` option is used). A restored
+# simulation is already past that point.
+def checkpoint() -> bool:
+    while True:
+        if args.checkpoint and not args.restore:
+            print("Saving checkpoint to ", args.checkpoint)
+            simulator.save_checkpoint(Path(args.checkpoint))
+            yield True
+        yield False
+
+
 # Lastly we run the simulation.
 # We define the system with the aforementioned system defined.
 simulator = Simulator(
@@ -195,6 +222,7 @@ simulator = Simulator(
     on_exit_event={
         ExitEvent.WORKBEGIN: workitems(True),
         ExitEvent.WORKEND: workitems(False),
+        ExitEvent.CHECKPOINT: checkpoint(),
         },
 )
 simulator.run()
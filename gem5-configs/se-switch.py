@@ -0,0 +1,255 @@
+# Copyright (c) 2025 Technical University of Munich
+# All rights reserved.
+#
+# The license below extends only to copyright in the software and shall
+# not be construed as granting a license to any other intellectual
+# property including but not limited to intellectual property relating
+# to a hardware implementation of the functionality of the software
+# licensed hereunder.  You may use the software subject to the license
+# terms below provided that you ensure that this notice is replicated
+# unmodified and in its entirety in all distributions of the software,
+# modified or unmodified, in source code or in binary form.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+gem5 configuration script that fast-forwards a binary in syscall emulation
+mode with a fast CPU and switches to a detailed CPU at the region of
+interest. `ubench` marks the region with `--m5-switch-cpu <N>`, which
+calls m5_switch_cpu before its N-th repeat (warmup repeats included).
+Warmup repeats after the switch warm up the caches and predictors of the
+detailed CPU before the measured repeats.
+
+Usage:
+  ./build/<ISA>/gem5.opt se-switch.py [--start-cpu atomic|kvm] \
+      [--cpu-type timing|o3] <BINARY_PATH> --m5-switch-cpu <N> <ARGS> ...
+
+Example: the first 8 of 10 warmup repeats run on the atomic CPU, the last
+2 warm up the O3 CPU.
+  ./build/X86/gem5.opt se-switch.py --isa X86 build-x64/ubench \
+      --config configs/random_branch.yaml --m5ops --warmup 10 \
+      --m5-switch-cpu 8 --repeats 5
+
+With `--start-cpu kvm` ubench must use the address based m5ops
+(`--m5-transport addr`).
+
+"""
+
+import argparse
+import m5
+
+from gem5.isas import ISA
+from gem5.utils.requires import requires
+from gem5.resources.resource import BinaryResource
+from gem5.components.memory import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes, get_mem_mode
+from gem5.components.boards.simple_board import SimpleBoard
+
+from gem5.components.cachehierarchies.classic.private_l1_private_l2_cache_hierarchy import (
+    PrivateL1PrivateL2CacheHierarchy,
+)
+from gem5.components.processors.simple_core import SimpleCore
+from gem5.components.processors.switchable_processor import (
+    SwitchableProcessor,
+)
+from gem5.simulate.simulator import Simulator
+from gem5.simulate.exit_event import ExitEvent
+
+from util.bp_configs import make_branch_pred
+
+
+isa_choices = {
+    "X86": ISA.X86,
+    "Arm": ISA.ARM,
+    "RiscV": ISA.RISCV,
+}
+
+start_cpu_types = {
+    "atomic": CPUTypes.ATOMIC,
+    "kvm": CPUTypes.KVM,
+}
+
+cpu_types = {
+    "timing": CPUTypes.TIMING,
+    "o3": CPUTypes.O3,
+}
+
+parser = argparse.ArgumentParser(
+    description="Fast-forward a binary in system call emulation and switch "
+    "to a detailed CPU at the region of interest"
+)
+
+parser.add_argument(
+    "--isa",
+    type=str,
+    default="X86",
+    help="The ISA to simulate.",
+    choices=isa_choices.keys(),
+)
+
+parser.add_argument(
+    "--start-cpu",
+    type=str,
+    default="atomic",
+    help="The CPU model to fast-forward with. KVM needs a host of the "
+    "same ISA and the address based m5ops.",
+    choices=start_cpu_types.keys(),
+)
+
+parser.add_argument(
+    "--cpu-type",
+    type=str,
+    default="o3",
+    help="The detailed CPU model used after the switch.",
+    choices=cpu_types.keys(),
+)
+
+
+parser.add_argument("cmd", nargs=argparse.REMAINDER)
+
+args = parser.parse_args()
+
+
+# This check ensures the gem5 binary is compiled to the correct ISA target.
+# If not, an exception will be thrown.
+requires(isa_required=isa_choices[args.isa])
+
+# We use a single channel DDR3_1600 memory system
+memory = SingleChannelDDR3_1600(size="512MiB")
+
+# We use a PrivateL1PrivateL2CacheHierarchy with 32kB L1 caches and 1MB L2.
+# The caches stay in place at the switch and are warm afterwards.
+cache_hierarchy = PrivateL1PrivateL2CacheHierarchy(
+    l1d_size="32KiB", l1i_size="32KiB", l2_size="1MiB"
+)
+
+class SwitchProcessor(SwitchableProcessor):
+    """
+    One core that starts with the fast CPU and switches to the detailed
+    CPU. Like SimpleSwitchableProcessor, but the detailed core gets the
+    branch predictor of se-simple.py before it is handed to the processor.
+    """
+
+    def __init__(self, starting_core_type, switch_core_type, isa):
+        switch_core = SimpleCore(cpu_type=switch_core_type, core_id=0, isa=isa)
+        switch_core.get_simobject().branchPred = make_branch_pred()
+        self._mem_mode = get_mem_mode(starting_core_type)
+        super().__init__(
+            switchable_cores={
+                "start": [
+                    SimpleCore(cpu_type=starting_core_type, core_id=0, isa=isa)
+                ],
+                "switch": [switch_core],
+            },
+            starting_cores="start",
+        )
+
+    def incorporate_processor(self, board):
+        super().incorporate_processor(board=board)
+        board.set_mem_mode(self._mem_mode)
+
+
+processor = SwitchProcessor(
+    starting_core_type=start_cpu_types[args.start_cpu],
+    switch_core_type=cpu_types[args.cpu_type],
+    isa=isa_choices[args.isa],
+)
+
+
+print(
+    "Running {} on {} CPU, switching to {} CPU: {}".format(
+        args.isa, args.start_cpu, args.cpu_type, args.cmd
+    )
+)
+
+
+# The gem5 library simble board which can be used to run simple SE-mode
+# simulations.
+board = SimpleBoard(
+    clk_freq="3GHz",
+    processor=processor,
+    memory=memory,
+    cache_hierarchy=cache_hierarchy,
+)
+
+
+# Under KVM the instruction based m5ops trap. Run ubench with
+# `--m5-transport addr`, which accesses the m5op region at this address.
+if args.start_cpu == "kvm":
+    board.m5ops_base = 0xFFFF0000 if args.isa == "X86" else 0x10010000
+
+
+# Here we set the workload.
+board.set_se_binary_workload(
+    binary=BinaryResource(args.cmd[0]),
+    arguments=args.cmd[1:],
+)
+
+# This function will be called when the benchmark reaches the repeat
+# given with `--m5-switch-cpu`. Everything after that is simulated with
+# the detailed CPU, ubench switches only once.
+def switch_cpu() -> bool:
+    print(f"Switching to {args.cpu_type} CPU @ tick: { m5.curTick() }")
+    processor.switch_to_processor("switch")
+    yield False
+    while True:
+        print(f"Already on {args.cpu_type} CPU @ tick: { m5.curTick() }")
+        yield False
+
+
+# This function will be called at the beginning and end of each
+# measured repetition of the benchmark (when the `-m/--m5ops` option is
+# used). It will print the current repetition number and dump the
+# statistics of the simulation.
+def workitems(start) -> bool:
+    cnt = 1
+    while True:
+        if start:
+            print(f"Begin Repetition {cnt} @ tick: { m5.curTick() }")
+            m5.stats.reset()
+        else:
+            print(f"End Repetition {cnt} @ tick: { m5.curTick() }")
+            m5.stats.dump()
+            cnt += 1
+
+        yield False
+
+
+# Lastly we run the simulation.
+# We define the system with the aforementioned system defined.
+simulator = Simulator(
+    board=board,
+    on_exit_event={
+        ExitEvent.SWITCHCPU: switch_cpu(),
+        ExitEvent.WORKBEGIN: workitems(True),
+        ExitEvent.WORKEND: workitems(False),
+        },
+)
+simulator.run()
+
+print(
+    "Exiting @ tick {} because {}.".format(
+        simulator.get_current_tick(), simulator.get_last_exit_event_cause()
+    )
+)
@@ -0,0 +1,53 @@
+# Copyright (c) 2025 Technical University of Munich
+# All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+The branch predictor of the detailed cores in the SE configs: LTAGE with
+a 16K entry BTB, optionally with ITTAGE for indirect branches.
+"""
+
+from m5.objects import (
+    SimpleBTB,
+    ITTAGE,
+    LTAGE,
+    LTAGE_TAGE,
+)
+
+
+class BTB(SimpleBTB):
+    numEntries = 16*1024
+    associativity = 8
+
+
+class BPTageSCL(LTAGE):
+    instShiftAmt = 2
+    btb = BTB()
+    tage = LTAGE_TAGE()
+    requiresBTBHit = True
+
+
+def make_branch_pred(ittage=False):
+    """A new predictor for one core, with ITTAGE instead of the default
+    indirect predictor if `ittage` is set"""
+    bp = BPTageSCL()
+    if ittage:
+        bp.indirectBranchPred = ITTAGE()
+    return bp
@@ -128,11 +128,14 @@ class GNRCacheHierarchy(PrivateL1PrivateL2CacheHierarchy):
 
     Setting `useL15D` adds another 195KiB LD cache between L1 and L2 hence L1.5D
     Setting `fdp` adds the FDP prefetcher to the L1I cache.
+    Setting `l3_size` overrides the size of the shared L3, e.g. to scale it
+    with the number of cores.
     """
-    def __init__(self, fdp=False, useL15D=False):
+    def __init__(self, fdp=False, useL15D=False, l3_size=None):
         super().__init__("", "", "")
         self._fdp = fdp
         self._useL15D = useL15D
+        self._l3_size = l3_size
 
 
     def incorporate_cache(self, board: AbstractBoard) -> None:
@@ -195,6 +198,8 @@ class GNRCacheHierarchy(PrivateL1PrivateL2CacheHierarchy):
         ]
 
         self.l3cache = L3Cache()
+        if self._l3_size:
+            self.l3cache.size = self._l3_size
         self.l3bus = L2XBar()
         self.membus.cpu_side_ports = self.l3cache.mem_side
         self.l3bus.mem_side_ports = self.l3cache.cpu_side
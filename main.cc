@@ -28,14 +28,20 @@
 
 
 
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <string>
+#include <vector>
 #include "benchmarks/base.hh"
+#include "runner.hh"
 // #include "utils/configs.h"
+#include "utils/env.hh"
 
 #include "utils/configs.h"
 // #include "utils/m5lib/m5lib.h"
-#include "utils/m5lib/m5ops.h"
+#include "utils/m5lib/phases.hh"
+#include "utils/m5lib/transport.hh"
 
 
 
@@ -54,44 +60,132 @@ int main(int argc, char **argv)
 		return 0;
 	}
 
-	cfg.print();
+	// Set up the execution environment. The re-exec without ASLR must
+	// come first as it starts the program over.
+	if (cfg.no_aslr && !reexecWithoutAslr(argv)) {
+		return 1;
+	}
+	if (cfg.cpu >= 0 && !pinToCpu(cfg.cpu)) {
+		return 1;
+	}
+	if (cfg.rt_priority > 0 && !setFifoPriority(cfg.rt_priority)) {
+		return 1;
+	}
+	if (cfg.mlock && !lockMemory()) {
+		return 1;
+	}
 
-	// Create the benchmark
-	BaseBenchmark* bench = createBenchmark(cfg.benchmark_name);
-	if (!bench) {
-		std::cerr << "Error creating benchmark: " << cfg.benchmark_name << std::endl;
+	if (!selectM5Transport(cfg.m5_transport, cfg.m5_addr)) {
 		return 1;
 	}
 
-	// Initialize the benchmark
-	if (!bench->init(cfg.bm_config)) {
-		delete bench;
-		std::cerr << "Error initializing benchmark: " << cfg.benchmark_name << std::endl;
+	cfg.print();
+
+	// Split a suite into its entries and expand the parameter sweeps of
+	// every entry. Each (entry, sweep point) pair is one run.
+	std::vector<Config> entries;
+	if (!expandSuite(cfg, entries)) {
+		std::cerr << "Error parsing the suite" << std::endl;
 		return 1;
 	}
 
-	// Run the benchmark
-	for (int j = 0; j < cfg.repeats; j++) {
-		std::cout << "Running iteration: " << j << std::endl;
+	struct Run { size_t entry; size_t point; YAML::Node config; };
+	std::vector<Run> runs;
+	std::vector<size_t> num_points;
+	for (size_t e = 0; e < entries.size(); e++) {
+		std::vector<YAML::Node> points;
+		if (!expandSweep(entries[e].bm_config, points)) {
+			std::cerr << "Error expanding the sweep of: " << entries[e].benchmark_name << std::endl;
+			return 1;
+		}
+		for (size_t p = 0; p < points.size(); p++) {
+			runs.push_back({e, p, points[p]});
+		}
+		num_points.push_back(points.size());
+	}
 
-		// Reset the benchmark
-		bench->repeat();
+	// A random order cancels out thermal and frequency drift
+	std::vector<size_t> order(runs.size());
+	for (size_t r = 0; r < runs.size(); r++) {
+		order[r] = r;
+	}
+	if (cfg.shuffle) {
+		unsigned seed = cfg.seed ? cfg.seed : std::random_device{}();
+		std::cout << "Shuffle runs with seed: " << seed << std::endl;
+		std::mt19937 rng(seed);
+		std::shuffle(order.begin(), order.end(), rng);
+	}
 
-		// Start measuring
-		if (cfg.use_m5ops) {
-			m5_work_begin(j, 0);
+	Runner runner(cfg);
+	if (!runner.setup()) {
+		return 1;
+	}
+
+	for (size_t r = 0; r < runs.size(); r++) {
+		const Run &run = runs[order[r]];
+		const Config &entry = entries[run.entry];
+		YAML::Node point = run.config;
+
+		if (runs.size() > 1) {
+			YAML::Node flow = YAML::Clone(point);
+			flow.SetStyle(YAML::EmitterStyle::Flow);
+			YAML::Emitter out;
+			out << flow;
+			std::cout << "Run " << r + 1 << "/" << runs.size();
+			if (num_points[run.entry] > 1) {
+				std::cout << " (sweep point " << run.point + 1 << "/"
+					  << num_points[run.entry] << ")";
+			}
+			std::cout << ": " << out.c_str() << std::endl;
 		}
 
-		bench->exec();
+		// Create the benchmark. Every run gets a fresh instance which is
+		// initialized with the config of the sweep point.
+		BaseBenchmark* bench = createBenchmark(entry.benchmark_name);
+		if (!bench) {
+			std::cerr << "Error creating benchmark: " << entry.benchmark_name << std::endl;
+			return 1;
+		}
 
-		// Stop measuring
-		if (cfg.use_m5ops) {
-			m5_work_end(j, 0);
+		// Initialize the benchmark and its copies for the worker threads
+		phaseMarker().setRun(entry.benchmark_name, run.point);
+		phaseMarker().begin(Phase::Init);
+		bool ok = bench->init(point);
+		std::vector<BaseBenchmark*> copies;
+		for (int t = 1; ok && t < cfg.threads; t++) {
+			copies.push_back(createBenchmark(entry.benchmark_name));
+			ok = copies.back()->init(point);
 		}
-	}
+		phaseMarker().end(Phase::Init);
+		if (!ok) {
+			delete bench;
+			for (auto *c : copies) {
+				delete c;
+			}
+			std::cerr << "Error initializing benchmark: " << entry.benchmark_name << std::endl;
+			return 1;
+		}
+
+		// Detailed simulations restore from here instead of simulating
+		// the setup of the benchmark
+		if (cfg.m5_checkpoint && r == 0) {
+			std::cout << "Taking checkpoint" << std::endl;
+			m5ops.m5_checkpoint(0, 0);
+		}
+
+		// Run the warmup and measured repeats
+		runner.run(bench, entry, point, run.point, copies);
+		runner.report();
 
-	// Print the results
-	bench->report();
+		// Print the results
+		phaseMarker().begin(Phase::Teardown);
+		bench->report();
 
-	delete bench;
+		delete bench;
+		for (auto *c : copies) {
+			delete c;
+		}
+		phaseMarker().end(Phase::Teardown);
+	}
+	runner.writePhases();
 }
@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+"""
+Convert the stats dumps of a gem5 run of ubench into the results schema of
+ubench (JSON lines or CSV, see utils/results.hh), such that simulated and
+real hardware results of the same benchmark config can be compared
+directly.
+
+The dumps of stats.txt are matched to the output ubench wrote in the
+simulation (`-o results.jsonl`):
+
+- With `--m5-phases` every dump has an `m5_region` label. Dumps of the
+  measure phase become repeat records, the other phases are written with
+  the phase as record type.
+- With `--m5ops` (work items) the n-th dump belongs to the n-th repeat
+  record.
+- Without the ubench output the n-th dump is repeat n of `--benchmark`.
+
+Usage:
+  ./plotting/gem5_stats.py m5out/stats.txt --results results.jsonl -o gem5.jsonl
+  ./plotting/gem5_stats.py m5out/stats.txt --benchmark random-branch -f csv -o gem5.csv
+"""
+
+import argparse
+import json
+import math
+import re
+import sys
+
+
+# gem5 statistic -> ubench metric. The first pattern that matches any stat
+# of a dump is used. If it matches the stats of several cores, the metric
+# is the sum over the cores, except `cycles`, which is the maximum (the
+# cores run in parallel, the slowest one takes the cycles of the region).
+# The value of every core is reported as well, as `<metric>_<core>` (e.g.
+# `cycles_cores1`). The patterns cover the atomic, timing and O3 CPUs of
+# recent gem5 versions.
+METRICS = {
+    "instructions": [
+        r"\.commitStats0\.numInsts$",
+        r"\.committedInsts$",
+        r"\.exec_context\.thread_0\.numInsts$",
+        r"^simInsts$",
+    ],
+    "cycles": [r"\.core\.numCycles$", r"\.numCycles$"],
+    "branches": [
+        r"\.branchPred\.committed_0::total$",
+        r"\.commit\.branches$",
+    ],
+    "branch-misses": [
+        r"\.branchPred\.mispredicted_0::total$",
+        r"\.commit\.branchMispredicts$",
+        r"\.branchPred\.condIncorrect$",
+    ],
+    "bp_lookups": [
+        r"\.branchPred\.lookups_0::total$",
+        r"\.branchPred\.lookups$",
+    ],
+    "btb_lookups": [
+        r"\.branchPred\.btb\.lookups::total$",
+        r"\.branchPred\.BTBLookups$",
+    ],
+    "btb_hits": [r"\.branchPred\.BTBHits$"],
+    "btb_misses": [r"\.branchPred\.btb\.misses::total$"],
+    "L1I-miss": [r"l1i[^.]*\.overallMisses::total$"],
+    "L1D-miss": [r"l1d[^.]*\.overallMisses::total$"],
+    "L2-miss": [r"l2[^.]*\.overallMisses::total$"],
+    "L3-miss": [r"l3[^.]*\.overallMisses::total$"],
+}
+
+AGGREGATE = {"cycles": max}
+
+BEGIN = "---------- Begin Simulation Statistics ----------"
+END = "---------- End Simulation Statistics   ----------"
+
+
+def parse_stats(path):
+    """Return the dumps of a stats.txt as list of {stat: value}"""
+    dumps = []
+    current = None
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith(BEGIN):
+                current = {}
+            elif line.startswith(END):
+                if current is not None:
+                    dumps.append(current)
+                current = None
+            elif current is not None and line:
+                fields = line.split()
+                if len(fields) < 2:
+                    continue
+                try:
+                    current[fields[0]] = float(fields[1])
+                except ValueError:
+                    pass
+    return dumps
+
+
+def is_miss(name):
+    name = name.lower()
+    return any(p in name for p in ("miss", "mis_pred", "refill", "walk"))
+
+
+def core_name(stat, match):
+    """The last numbered component of a stat before the matched part,
+    e.g. `cores1` of `board.processor.cores1.core.numCycles`"""
+    numbered = re.findall(r"[A-Za-z_]+\d+(?=\.)", stat[:match.start() + 1])
+    return numbered[-1] if numbered else stat
+
+
+def normalize(dump, ops=None):
+    """Map the gem5 stats of a dump to ubench metrics and units"""
+    metrics, units = {}, {}
+    per_core = {}
+    for metric, patterns in METRICS.items():
+        for pattern in patterns:
+            regex = re.compile(pattern)
+            matches = [(k, v, regex.search(k)) for k, v in dump.items()]
+            matches = [(k, v, m) for k, v, m in matches if m]
+            if matches:
+                values = [v for _, v, _ in matches]
+                metrics[metric] = AGGREGATE.get(metric, sum)(values)
+                units[metric] = "events"
+                if len(matches) > 1:
+                    for k, v, m in matches:
+                        per_core[metric + "_" + core_name(k, m)] = v
+                break
+    if "btb_hits" not in metrics and "btb_misses" in metrics \
+            and "btb_lookups" in metrics:
+        metrics["btb_hits"] = metrics["btb_lookups"] - metrics["btb_misses"]
+        units["btb_hits"] = "events"
+    for name in ("L3-miss", "L2-miss"):
+        if name in metrics:
+            metrics["cache-misses"] = metrics[name]
+            units["cache-misses"] = "events"
+            break
+    if "simSeconds" in dump:
+        metrics["time_ns"] = dump["simSeconds"] * 1e9
+        units["time_ns"] = "ns"
+    if "simTicks" in dump:
+        metrics["sim_ticks"] = dump["simTicks"]
+        units["sim_ticks"] = "ticks"
+
+    # The same normalization as the runner (see Runner::perOpMetrics)
+    measured = list(metrics)
+    instructions = metrics.get("instructions", 0)
+    for name in measured:
+        if units[name] == "events" and instructions > 0 and is_miss(name):
+            metrics[name + "_mpki"] = metrics[name] * 1000 / instructions
+            units[name + "_mpki"] = "events/kinst"
+    if ops:
+        metrics["ops"] = ops
+        units["ops"] = "ops"
+        if metrics.get("time_ns"):
+            metrics["ops_per_sec"] = ops * 1e9 / metrics["time_ns"]
+            units["ops_per_sec"] = "ops/s"
+        for name in measured:
+            metrics[name + "_per_op"] = metrics[name] / ops
+            units[name + "_per_op"] = units[name] + "/op"
+    for name, value in per_core.items():
+        metrics[name] = value
+        units[name] = "events"
+    return metrics, units
+
+
+def read_results(path):
+    """Return the repeat records and dump labels of a ubench output"""
+    repeats, labels = [], {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            rec = json.loads(line)
+            if rec.get("type") == "repeat":
+                repeats.append(rec)
+            elif rec.get("type") == "m5_region":
+                labels[rec["dump"]] = rec
+    return repeats, labels
+
+
+def match(dumps, repeats, labels, benchmark):
+    """Return (record type, run info, dump) for every matched dump"""
+    configs = {}
+    for rec in repeats:
+        configs[(rec["benchmark"], rec["point"])] = rec
+    matched = []
+    if labels:
+        for i, dump in enumerate(dumps):
+            label = labels.get(i)
+            if label is None:
+                continue
+            run = dict(configs.get((label["benchmark"], label["point"]), {}))
+            run.update(benchmark=label["benchmark"], point=label["point"],
+                       repeat=label["repeat"], region=label["region"])
+            kind = "repeat" if label["phase"] == "measure" else label["phase"]
+            matched.append((kind, run, dump))
+    elif repeats:
+        # One dump per repeat, plus the final dump at the exit of gem5
+        if len(dumps) not in (len(repeats), len(repeats) + 1):
+            print("Warning: {} dumps for {} repeats, the work items do not "
+                  "match the repeats one by one".format(
+                      len(dumps), len(repeats)), file=sys.stderr)
+        for rec, dump in zip(repeats, dumps):
+            matched.append(("repeat", dict(rec, region=""), dump))
+    else:
+        for i, dump in enumerate(dumps):
+            matched.append(("repeat", {"benchmark": benchmark, "point": 0,
+                                       "repeat": i, "region": ""}, dump))
+    if len(matched) < len(dumps):
+        print("Ignored {} of {} dumps without a repeat".format(
+            len(dumps) - len(matched), len(dumps)), file=sys.stderr)
+    return matched
+
+
+def percentile(values, p):
+    rank = p / 100.0 * (len(values) - 1)
+    lo, hi = math.floor(rank), math.ceil(rank)
+    return values[lo] + (values[hi] - values[lo]) * (rank - lo)
+
+
+T95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+       2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+       2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+       2.042]
+
+
+def summarize(samples):
+    """Same statistics as summarize() in utils/stats.cc"""
+    s = sorted(samples)
+    n = len(s)
+    mean = sum(s) / n
+    stddev = math.sqrt(sum((x - mean) ** 2 for x in s) / (n - 1)) \
+        if n > 1 else 0.0
+    if n < 2:
+        rel_ci = None
+    elif stddev == 0:
+        rel_ci = 0.0
+    elif mean == 0:
+        rel_ci = None
+    else:
+        t = T95[n - 2] if n - 1 <= len(T95) else 1.960
+        rel_ci = abs(t * stddev / math.sqrt(n) / mean)
+    return {"n": n, "min": s[0], "median": percentile(s, 50), "mean": mean,
+            "p90": percentile(s, 90), "p99": percentile(s, 99),
+            "stddev": stddev, "rel_ci": rel_ci}
+
+
+CSV_HEADER = ("type,benchmark,point,config,repeat,outlier,noise,rejected,"
+              "metric,unit,value,n,min,median,mean,p90,p99,stddev,rel_ci")
+
+
+def csv_field(value):
+    if value is None:
+        return ""
+    s = value if isinstance(value, str) else json.dumps(value)
+    if any(c in s for c in ',"\n'):
+        s = '"' + s.replace('"', '""') + '"'
+    return s
+
+
+def write(out, fmt, matched):
+    if fmt == "csv":
+        print(CSV_HEADER, file=out)
+
+    groups = {}
+    for kind, run, dump in matched:
+        ops = run.get("metrics", {}).get("ops")
+        metrics, units = normalize(dump, ops)
+        config = run.get("config")
+        region = run.get("region", "")
+        if kind == "repeat":
+            key = (run["benchmark"], run["point"], region)
+            group = groups.setdefault(key, (config, {}, []))
+            group[1].update(units)
+            group[2].append(metrics)
+
+        if fmt == "csv":
+            for name, value in sorted(metrics.items()):
+                metric = region + "/" + name if region else name
+                print(",".join([kind, csv_field(run["benchmark"]),
+                                str(run["point"]),
+                                csv_field(json.dumps(config)),
+                                csv_field(run.get("repeat")), "false", "",
+                                "false", csv_field(metric),
+                                csv_field(units[name]), repr(value)]
+                               + [""] * 8), file=out)
+            continue
+        rec = {"type": kind, "benchmark": run["benchmark"],
+               "point": run["point"], "config": config,
+               "repeat": run.get("repeat"), "outlier": False, "noise": "",
+               "rejected": False, "metrics": metrics, "units": units}
+        if region:
+            rec["region"] = region
+        print(json.dumps(rec), file=out)
+
+    for (benchmark, point, region), (config, units, samples) in groups.items():
+        names = sorted({m for s in samples for m in s})
+        summaries = {m: summarize([s[m] for s in samples if m in s])
+                     for m in names}
+        if fmt == "csv":
+            for m, s in summaries.items():
+                metric = region + "/" + m if region else m
+                print(",".join(["summary", csv_field(benchmark), str(point),
+                                csv_field(json.dumps(config)), "", "", "", "",
+                                csv_field(metric), csv_field(units.get(m)),
+                                ""] + [csv_field(s[k]) for k in
+                                       ("n", "min", "median", "mean", "p90",
+                                        "p99", "stddev", "rel_ci")]),
+                      file=out)
+            continue
+        rec = {"type": "summary", "benchmark": benchmark, "point": point,
+               "config": config, "repeats": len(samples), "rejected": 0,
+               "rejected_reasons": {},
+               "metrics": {m: dict(unit=units.get(m, ""), **s)
+                           for m, s in summaries.items()}}
+        if region:
+            rec["region"] = region
+        print(json.dumps(rec), file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert gem5 stats dumps into ubench results")
+    parser.add_argument("stats", help="stats.txt of the gem5 run")
+    parser.add_argument("--results", help="Output of ubench in the "
+                        "simulation (JSON lines) to match the dumps")
+    parser.add_argument("--benchmark", default="gem5",
+                        help="Benchmark name without --results")
+    parser.add_argument("-o", "--output", default="-",
+                        help="Output file ('-' for stdout)")
+    parser.add_argument("-f", "--format", default="json",
+                        choices=["json", "csv"])
+    args = parser.parse_args()
+
+    dumps = parse_stats(args.stats)
+    repeats, labels = read_results(args.results) if args.results else ([], {})
+    matched = match(dumps, repeats, labels, args.benchmark)
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    write(out, args.format, matched)
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Implementation of the benchmark runner.
+ */
+
+#include "runner.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+#include "utils/m5lib/transport.hh"
+#include "utils/perf/events.hh"
+#include "utils/perf/topdown.hh"
+#include "utils/stats.hh"
+
+Runner::Runner(Config &_cfg)
+	: cfg(_cfg),
+	  active_perf(nullptr),
+	  use_noise(false),
+	  noise_tried(false),
+	  noise_open(false),
+	  num_run(0),
+	  cpu_switched(false),
+	  policy(&_cfg),
+	  ci_metric(_cfg.ci_metric)
+{
+}
+
+bool Runner::setup()
+{
+	if (!phaseMarker().configure(cfg.m5_phases)) {
+		return false;
+	}
+
+	if (!cfg.output.empty() &&
+	    !writer.open(cfg.output, cfg.output_format)) {
+		return false;
+	}
+
+	if (cfg.threads > 1) {
+		pool = std::make_unique<WorkerPool>(cfg.threads - 1, cfg.cpu);
+	}
+
+	if (cfg.use_timer) {
+		timer.calibrate();
+		std::cout << "Timer overhead: " << timer.getOverhead()
+			  << " ticks, frequency: " << timer.getTicksPerNs()
+			  << " ticks/ns" << std::endl;
+	}
+	return true;
+}
+
+void Runner::openPerf(const Config &entry)
+{
+	std::string key = std::to_string(entry.perf_group_size);
+	for (auto &e : entry.perf_events) {
+		key += "," + e;
+	}
+	if (key == perf_key) {
+		return;
+	}
+	perf_key = key;
+	active_perf = nullptr;
+	perf_groups.clear();
+
+	// The groups stay open across runs. The counters are enabled only
+	// around the exec() call of each repeat.
+	std::vector<EventSpec> specs;
+	if (!resolveEvents(entry.perf_events, specs) ||
+	    !openEventGroups(specs, perf_groups, cfg.use_rdpmc,
+			     entry.perf_group_size)) {
+		std::cerr << "Error opening perf counters" << std::endl;
+		return;
+	}
+	if (perf_groups.size() > 1) {
+		std::cout << "Perf events split into " << perf_groups.size()
+			  << " groups, measured in turns" << std::endl;
+	}
+}
+
+RepeatRecord Runner::runRepeat(BaseBenchmark *bench, int id, Phase phase)
+{
+	RepeatRecord rec;
+	rec.id = id;
+	rec.outlier = false;
+
+	// Counter group of this repeat
+	PerfEvent *perf = perf_groups.empty()
+		? nullptr : perf_groups[id % perf_groups.size()].get();
+	// Pinned groups read in user space run continuously. Only the one
+	// of this repeat may hold the counters.
+	if (perf && perf->hasUserRead() && perf != active_perf) {
+		if (active_perf) {
+			active_perf->setActive(false);
+		}
+		perf->setActive(true);
+		active_perf = perf;
+	}
+
+	// Fast-forward until here, simulate the rest with the detailed CPU
+	if (!cpu_switched && cfg.m5_switch_cpu == num_run) {
+		std::cout << "Switching CPU" << std::endl;
+		m5ops.m5_switch_cpu();
+		cpu_switched = true;
+	}
+	num_run++;
+
+	// The interrupts are read before the reset, which brings the data of
+	// the benchmark back into the caches
+	if (use_noise) {
+		noise.snapshot();
+	}
+
+	// Reset the benchmark
+	bench->repeat();
+	for (auto *w : workers) {
+		w->repeat();
+	}
+
+	// Start measuring
+	if (use_noise) {
+		noise.start();
+	}
+	// The phases replace the work items
+	bool work_item = phase == Phase::Measure && cfg.use_m5ops &&
+		!phaseMarker().active();
+	bool parallel = pool && !workers.empty();
+	auto start = std::chrono::steady_clock::now();
+	uint64_t tick_start = cfg.use_timer ? RegionTimer::start() : 0;
+
+	// The gem5 markers hold exec() only, not the host timers. The
+	// counters are innermost and count neither timers nor markers (gem5
+	// does not implement perf_event_open, the two are never both used).
+	if (work_item) {
+		m5ops.m5_work_begin(id, 0);
+	}
+	phaseMarker().begin(phase, id);
+	if (perf) {
+		perf->start();
+	}
+
+	// The workers run their copies concurrently, each tags its own work
+	// item with its thread ID such that gem5 sees the region per core
+	if (parallel) {
+		pool->start([&](int tid) {
+			if (work_item) {
+				m5ops.m5_work_begin(id, tid);
+			}
+			workers[tid - 1]->exec();
+			if (work_item) {
+				m5ops.m5_work_end(id, tid);
+			}
+		});
+	}
+
+	bench->exec();
+
+	if (parallel) {
+		pool->wait();
+	}
+
+	// Stop measuring
+	if (perf) {
+		perf->stop();
+	}
+	phaseMarker().end(phase);
+	if (work_item) {
+		m5ops.m5_work_end(id, 0);
+	}
+	uint64_t tick_stop = cfg.use_timer ? RegionTimer::stop() : 0;
+	auto stop = std::chrono::steady_clock::now();
+	if (use_noise) {
+		noise.stop();
+	}
+
+	rec.metrics["time_ns"] =
+		std::chrono::duration<double, std::nano>(stop - start).count();
+	units["time_ns"] = "ns";
+	measured.insert("time_ns");
+	if (cfg.use_timer) {
+		double ticks = timer.net(tick_start, tick_stop);
+		rec.metrics["ticks"] = ticks;
+		rec.metrics["ticks_ns"] = timer.toNs(ticks);
+		units["ticks"] = "ticks";
+		units["ticks_ns"] = "ns";
+		measured.insert({"ticks", "ticks_ns"});
+	}
+	if (perf) {
+		auto counters = perf->getCounters();
+		for (auto &c : counters) {
+			rec.metrics[c.first] = c.second;
+			units[c.first] = "events";
+			measured.insert(c.first);
+		}
+
+		// Effective frequency of the core during the region
+		for (auto name : {"cycles", "cpu-cycles", "CPU_CYCLES"}) {
+			if (counters.count(name) && rec.metrics["time_ns"] > 0) {
+				rec.metrics["freq_ghz"] = counters[name] /
+					rec.metrics["time_ns"];
+				units["freq_ghz"] = "GHz";
+				break;
+			}
+		}
+
+		// Top-down breakdown if the group has the events for it
+		MetricSink tma;
+		topdownMetrics(counters, tma);
+		for (auto &m : tma.get()) {
+			rec.metrics[m.name] = m.value;
+			units[m.name] = m.unit;
+		}
+	}
+
+	if (use_noise) {
+		MetricSink sink;
+		noise.metrics(sink);
+		for (auto &m : sink.get()) {
+			rec.metrics[m.name] = m.value;
+			units[m.name] = m.unit;
+		}
+		rec.noise = noise.perturbations(policy->max_interrupts,
+						policy->max_page_faults);
+	}
+
+	// Results of the benchmark itself
+	MetricSink sink;
+	bench->metrics(sink);
+	for (auto &m : sink.get()) {
+		rec.metrics[m.name] = m.value;
+		units[m.name] = m.unit;
+	}
+
+	double ops = bench->opCount();
+	if (ops > 0) {
+		perOpMetrics(rec, ops, bench->opUnit());
+	}
+	return rec;
+}
+
+/** Counters of misses, mispredictions, refills and page walks */
+static bool isMissEvent(std::string name)
+{
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	for (auto pattern : {"miss", "mis_pred", "refill", "walk"}) {
+		if (name.find(pattern) != std::string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void Runner::perOpMetrics(RepeatRecord &rec, double ops,
+			  const std::string &unit)
+{
+	MetricSink sink;
+	sink.counter("ops", ops, unit);
+	sink.rate("ops_per_sec", ops * 1e9, rec.metrics["time_ns"],
+		  unit + "/s");
+
+	double instructions = 0;
+	for (auto name : {"instructions", "INST_RETIRED"}) {
+		if (rec.metrics.count(name)) {
+			instructions = rec.metrics[name];
+		}
+	}
+	for (auto &m : rec.metrics) {
+		if (!measured.count(m.first)) {
+			continue;
+		}
+		sink.rate(m.first + "_per_op", m.second, ops,
+			  units[m.first] + "/op");
+		if (units[m.first] == "events" && instructions > 0 &&
+		    isMissEvent(m.first)) {
+			sink.rate(m.first + "_mpki", m.second * 1000,
+				  instructions, "events/kinst");
+		}
+	}
+	for (auto &m : sink.get()) {
+		rec.metrics[m.name] = m.value;
+		units[m.name] = m.unit;
+	}
+}
+
+std::vector<double> Runner::samples(const std::string &metric) const
+{
+	std::vector<double> values;
+	for (auto &rec : records) {
+		auto it = rec.metrics.find(metric);
+		if (!rejected(rec) && it != rec.metrics.end()) {
+			values.push_back(it->second);
+		}
+	}
+	return values;
+}
+
+bool Runner::rejected(const RepeatRecord &rec) const
+{
+	return rec.outlier ||
+		(policy->noise == "discard" && !rec.noise.empty());
+}
+
+void Runner::markFrequency()
+{
+	std::vector<double> freqs;
+	for (auto &rec : records) {
+		auto it = rec.metrics.find("freq_ghz");
+		if (it != rec.metrics.end()) {
+			freqs.push_back(it->second);
+		}
+	}
+	if (freqs.empty() || policy->noise == "off") {
+		return;
+	}
+	double median = summarize(freqs).median;
+	for (auto &rec : records) {
+		auto it = rec.metrics.find("freq_ghz");
+		if (it == rec.metrics.end()) {
+			continue;
+		}
+		bool off = std::abs(it->second - median) >
+			policy->freq_tolerance * median;
+		auto pos = std::find(rec.noise.begin(), rec.noise.end(),
+				     "frequency");
+		if (off && pos == rec.noise.end()) {
+			rec.noise.push_back("frequency");
+		} else if (!off && pos != rec.noise.end()) {
+			rec.noise.erase(pos);
+		}
+	}
+}
+
+void Runner::markOutliers()
+{
+	// With several counter groups only some repeats have the metric.
+	// Discarded perturbed repeats do not count.
+	std::vector<double> values;
+	std::vector<RepeatRecord *> measured;
+	for (auto &rec : records) {
+		rec.outlier = false;
+		auto it = rec.metrics.find(ci_metric);
+		if (it != rec.metrics.end() && !rejected(rec)) {
+			values.push_back(it->second);
+			measured.push_back(&rec);
+		}
+	}
+	auto outliers = findOutliers(values, policy->outlier_k);
+	for (size_t i = 0; i < measured.size(); i++) {
+		measured[i]->outlier = outliers[i];
+	}
+}
+
+void Runner::runNull(BaseBenchmark *bench)
+{
+	// The null repeats are not tagged as work items, the gem5 stats
+	// only cover the benchmark itself
+	bench->setNull(true);
+	for (auto *w : workers) {
+		w->setNull(true);
+	}
+	for (int w = 0; w < policy->warmup; w++) {
+		runRepeat(bench, w, Phase::Null);
+	}
+	std::map<std::string, std::vector<double>> values;
+	for (int j = 0; j < policy->repeats; j++) {
+		std::cout << "Running null iteration: " << j << std::endl;
+		RepeatRecord rec = runRepeat(bench, j, Phase::Null);
+		if (policy->noise == "discard" && !rec.noise.empty()) {
+			continue;
+		}
+		for (auto &m : rec.metrics) {
+			if (measured.count(m.first)) {
+				values[m.first].push_back(m.second);
+			}
+		}
+	}
+	bench->setNull(false);
+	for (auto *w : workers) {
+		w->setNull(false);
+	}
+
+	null_medians.clear();
+	for (auto &v : values) {
+		null_medians[v.first] = summarize(v.second).median;
+	}
+}
+
+void Runner::subtractNull(double ops)
+{
+	for (auto &rec : records) {
+		for (auto &n : null_medians) {
+			auto it = rec.metrics.find(n.first);
+			if (it == rec.metrics.end()) {
+				continue;
+			}
+			std::string name = "net_" + n.first + "_per_op";
+			rec.metrics[name] = (it->second - n.second) / ops;
+		}
+	}
+	for (auto &n : null_medians) {
+		units["net_" + n.first + "_per_op"] = units[n.first] + "/op";
+	}
+}
+
+bool Runner::converged() const
+{
+	return relativeCI(samples(ci_metric)) <= policy->target_ci;
+}
+
+static void printRecord(const RepeatRecord &rec)
+{
+	int width = 15;
+	for (auto &m : rec.metrics) {
+		bool integral = m.second == std::floor(m.second);
+		std::cout << std::setw(width) << m.first << ": "
+			  << std::fixed << std::setprecision(integral ? 0 : 4)
+			  << m.second << std::endl;
+	}
+}
+
+void Runner::run(BaseBenchmark *bench, const Config &entry,
+		 const YAML::Node &bm_config, int point,
+		 const std::vector<BaseBenchmark *> &copies)
+{
+	// Units and the metrics to correct by the null variant belong to
+	// the benchmark of this run
+	records.clear();
+	units.clear();
+	measured.clear();
+	workers = copies;
+	num_run = 0;
+	policy = &entry;
+	ci_metric = entry.ci_metric;
+	// Software events and interrupts of the measuring core. Opened with
+	// the first entry that asks for them, gem5 SE does not implement
+	// perf_event_open.
+	if (entry.noise != "off" && !noise_tried) {
+		noise_open = noise.init(cfg.cpu);
+		noise_tried = true;
+	}
+	use_noise = noise_open && entry.noise != "off";
+	if (cfg.use_perf) {
+		openPerf(entry);
+	}
+	info.benchmark = bench->getName();
+	// Rebind instead of assign, assigning a YAML::Node overwrites the
+	// node the previous run was bound to
+	info.config.reset(bm_config);
+	info.point = point;
+
+	// The null variant runs first such that the benchmark is left in
+	// the state of its last measured repeat
+	null_medians.clear();
+	if (policy->null_baseline) {
+		if (!bench->hasNull() || bench->opCount() <= 0) {
+			std::cerr << "Warning: " << info.benchmark
+				  << " has no null variant or operation count"
+				  << std::endl;
+		} else {
+			runNull(bench);
+		}
+	}
+
+	// Warmup repeats bring caches and predictors into a steady state.
+	// Their measurements are discarded.
+	for (int w = 0; w < policy->warmup; w++) {
+		std::cout << "Running warmup: " << w << std::endl;
+		runRepeat(bench, w, Phase::Warmup);
+	}
+
+	bool adaptive = policy->target_ci > 0;
+	int limit = adaptive ? std::max(policy->max_repeats, policy->repeats)
+			     : policy->repeats;
+	auto start = std::chrono::steady_clock::now();
+
+	for (int j = 0; j < limit; j++) {
+		std::cout << "Running iteration: " << j << std::endl;
+		records.push_back(runRepeat(bench, j, Phase::Measure));
+		printRecord(records.back());
+
+		// Every counter group was measured once
+		if (j + 1 == (int)std::max<size_t>(perf_groups.size(), 1) &&
+		    samples(ci_metric).empty()) {
+			std::cerr << "Unknown CI metric: " << ci_metric
+				  << ". Using time_ns" << std::endl;
+			ci_metric = "time_ns";
+		}
+
+		// The configured repeats are the minimum in adaptive mode
+		if (!adaptive || j + 1 < policy->repeats) {
+			continue;
+		}
+		markFrequency();
+		markOutliers();
+		if (converged()) {
+			std::cout << "Reached target CI after " << j + 1
+				  << " repeats" << std::endl;
+			break;
+		}
+		std::chrono::duration<double> elapsed =
+			std::chrono::steady_clock::now() - start;
+		if (policy->max_time > 0 && elapsed.count() >= policy->max_time) {
+			std::cout << "Time budget exhausted after " << j + 1
+				  << " repeats" << std::endl;
+			break;
+		}
+	}
+	markFrequency();
+	markOutliers();
+
+	if (adaptive && !converged()) {
+		std::cerr << "Warning: target CI of " << policy->target_ci
+			  << " not reached" << std::endl;
+	}
+
+	if (!null_medians.empty()) {
+		subtractNull(bench->opCount());
+	}
+
+	for (auto &rec : records) {
+		std::string reasons;
+		for (auto &n : rec.noise) {
+			reasons += (reasons.empty() ? "" : ",") + n;
+		}
+		writer.writeRepeat(info, rec.id, rec.outlier, reasons,
+				   rejected(rec), rec.metrics, units);
+	}
+}
+
+void Runner::report()
+{
+	// Count the reasons a repeat was rejected and the perturbations
+	size_t num_rejected = 0, num_perturbed = 0;
+	std::map<std::string, size_t> reasons, perturbations;
+	std::set<std::string> metrics;
+	for (auto &rec : records) {
+		if (rejected(rec)) {
+			num_rejected++;
+			if (rec.outlier) {
+				reasons["outlier"]++;
+			} else {
+				for (auto &n : rec.noise) {
+					reasons[n]++;
+				}
+			}
+		}
+		num_perturbed += rec.noise.empty() ? 0 : 1;
+		for (auto &n : rec.noise) {
+			perturbations[n]++;
+		}
+		for (auto &m : rec.metrics) {
+			metrics.insert(m.first);
+		}
+	}
+
+	std::cout << "----------------------------------------" << std::endl;
+	std::cout << " Summary " << info.benchmark << std::endl;
+	std::cout << "----------------------------------------" << std::endl;
+	std::cout << "Measured repeats:\t" << records.size() << std::endl;
+	auto printReasons = [](const std::map<std::string, size_t> &r) {
+		std::string sep = " (";
+		for (auto &it : r) {
+			std::cout << sep << it.first << ": " << it.second;
+			sep = ", ";
+		}
+		std::cout << (r.empty() ? "" : ")") << std::endl;
+	};
+	std::cout << "Rejected repeats:\t" << num_rejected;
+	printReasons(reasons);
+	if (use_noise) {
+		std::cout << "Perturbed repeats:\t" << num_perturbed;
+		printReasons(perturbations);
+	}
+	for (auto &n : null_medians) {
+		std::cout << "Null " << n.first << ":\t" << std::fixed
+			  << std::setprecision(1) << n.second << std::endl;
+	}
+
+	int width = 15;
+	int name_width = 24;
+	std::cout << std::setw(name_width) << "metric"
+		  << std::setw(width) << "min"
+		  << std::setw(width) << "median"
+		  << std::setw(width) << "mean"
+		  << std::setw(width) << "p90"
+		  << std::setw(width) << "p99"
+		  << std::setw(width) << "stddev"
+		  << std::setw(width) << "rel. CI" << std::endl;
+	std::map<std::string, Summary> summaries;
+	for (auto &metric : metrics) {
+		Summary sum = summarize(samples(metric));
+		summaries[metric] = sum;
+		std::cout << std::setw(name_width) << metric
+			  << std::fixed << std::setprecision(1)
+			  << std::setw(width) << sum.min
+			  << std::setw(width) << sum.median
+			  << std::setw(width) << sum.mean
+			  << std::setw(width) << sum.p90
+			  << std::setw(width) << sum.p99
+			  << std::setw(width) << sum.stddev
+			  << std::setprecision(4)
+			  << std::setw(width) << sum.rel_ci << std::endl;
+	}
+	std::cout << "----------------------------------------" << std::endl;
+
+	writer.writeSummary(info, records.size(), num_rejected, reasons,
+			    summaries, units);
+	writePhases();
+}
+
+void Runner::writePhases()
+{
+	for (auto &label : phaseMarker().takeLabels()) {
+		std::cout << "m5 stats dump " << label.dump << ": "
+			  << phaseName(label.phase);
+		if (label.repeat >= 0) {
+			std::cout << " " << label.repeat;
+		}
+		if (!label.region.empty()) {
+			std::cout << " " << label.region;
+		}
+		std::cout << std::endl;
+		RunInfo run;
+		run.benchmark = label.benchmark;
+		run.point = label.point;
+		writer.writeRegion(run, label.dump, phaseName(label.phase),
+				   static_cast<int>(label.phase), label.repeat,
+				   label.region);
+	}
+}
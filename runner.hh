@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * The runner executes the repeats of a benchmark, measures each repeat
+ * and summarizes the measurements.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "benchmarks/base.hh"
+#include "utils/configs.h"
+#include "utils/m5lib/phases.hh"
+#include "utils/noise.hh"
+#include "utils/perf/perf.hh"
+#include "utils/results.hh"
+#include "utils/timer.hh"
+#include "utils/workers.hh"
+
+/** The measurements of one repeat */
+struct RepeatRecord
+{
+	int id;
+	bool outlier;
+	/** Events that perturbed the repeat (see NoiseMonitor) */
+	std::vector<std::string> noise;
+	std::map<std::string, double> metrics;
+};
+
+class Runner
+{
+  private:
+	Config &cfg;
+	/** Counter groups. Each repeat measures one group, round robin. */
+	std::vector<std::unique_ptr<PerfEvent>> perf_groups;
+	/** Events and group size the groups were opened for */
+	std::string perf_key;
+	/** The enabled group if the groups are read in user space */
+	PerfEvent *active_perf;
+	RegionTimer timer;
+	ResultWriter writer;
+	NoiseMonitor noise;
+	/** Monitor the noise in the current run. The monitor is opened
+	 * once, by the first run that asks for it. */
+	bool use_noise;
+	bool noise_tried;
+	bool noise_open;
+
+	/** Repeats run so far in this run (null, warmup and measured) and
+	 * whether the gem5 CPU was switched already */
+	int num_run;
+	bool cpu_switched;
+
+	/** Repeat policy of the last run and the metric used for the CI */
+	const Config *policy;
+	std::string ci_metric;
+
+	/** Copies of the benchmark that the worker threads execute
+	 * concurrently with the measured one (--threads) */
+	std::vector<BaseBenchmark *> workers;
+	std::unique_ptr<WorkerPool> pool;
+
+	/** Benchmark, config and sweep point of the last run */
+	RunInfo info;
+
+	/** Unit of each metric */
+	std::map<std::string, std::string> units;
+
+	/** Metrics measured around exec() (time, ticks, perf counters).
+	 * Only these are corrected by the null baseline. */
+	std::set<std::string> measured;
+
+	/** Median of each measured metric of the null variant */
+	std::map<std::string, double> null_medians;
+
+	/** Measured repeats of the last run */
+	std::vector<RepeatRecord> records;
+
+	/** Run a single repeat of a phase (warmup, measure or null) and
+	 * return its measurements */
+	RepeatRecord runRepeat(BaseBenchmark *bench, int id, Phase phase);
+
+	/** All samples of a metric that are not rejected */
+	std::vector<double> samples(const std::string &metric) const;
+
+	/** A repeat is excluded from the summary if it is an outlier or
+	 * perturbed and the noise policy discards perturbed repeats */
+	bool rejected(const RepeatRecord &rec) const;
+
+	/** Flag outliers of the CI metric */
+	void markOutliers();
+
+	/** Flag repeats whose effective frequency deviates from the median */
+	void markFrequency();
+
+	/** Add the operations of the repeat, the operations per second,
+	 * the measured metrics per operation and the misses per kilo
+	 * instruction (MPKI) */
+	void perOpMetrics(RepeatRecord &rec, double ops,
+			  const std::string &unit);
+
+	/** Measure the null variant of the benchmark with the warmup and
+	 * the (minimum) number of repeats of the policy */
+	void runNull(BaseBenchmark *bench);
+
+	/** Add the net cost per operation (measured - null) / ops to every
+	 * repeat */
+	void subtractNull(double ops);
+
+	/** Check if the adaptive stopping criterion is met */
+	bool converged() const;
+
+	/** (Re)open the counter groups if the entry asks for other events */
+	void openPerf(const Config &entry);
+
+  public:
+	Runner(Config &_cfg);
+
+	/** Calibrate the timer and open the output. Must be called once
+	 * before run() */
+	bool setup();
+
+	/**
+	 * @brief Run warmup and measured repeats of an initialized benchmark
+	 *
+	 * @param bench The benchmark
+	 * @param entry The config of the benchmark (repeat policy)
+	 * @param bm_config The config the benchmark was initialized with
+	 * @param point Index of the sweep point (tagged in the output)
+	 * @param copies Initialized copies of the benchmark, one per worker
+	 *        thread (threads - 1)
+	 */
+	void run(BaseBenchmark *bench, const Config &entry,
+		 const YAML::Node &bm_config, int point = 0,
+		 const std::vector<BaseBenchmark *> &copies = {});
+
+	/** Print min/median/mean/p90/p99/stddev for every metric and write
+	 * the summary record */
+	void report();
+
+	/** Print and write the labels of the gem5 stats dumps so far */
+	void writePhases();
+
+	const std::vector<RepeatRecord> &getRecords() const { return records; }
+};
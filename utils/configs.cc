@@ -27,13 +27,35 @@
  */
 
 #include "configs.h"
+#include "results.hh"
 #include <iostream>
 #include <string>
 #include <map>
+#include <set>
 // #include <boost/program_options.hpp>
 
 // namespace po = boost::program_options;
 
+/**
+ * @brief Split a comma separated list
+ */
+static std::vector<std::string> splitList(const std::string &str)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= str.size()) {
+        size_t end = str.find(',', start);
+        if (end == std::string::npos) {
+            end = str.size();
+        }
+        if (end > start) {
+            items.push_back(str.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
 /**
  * @brief Parse the command line options and the config file
  * 
@@ -51,7 +73,9 @@ bool parseConfigs(int argc, char **argv, Config &config)
     // Parse command line arguments into a map
     for (int i = 1; i < argc; i++) {
         std::string key = argv[i];
-        if (key[0] == '-' && i + 1 < argc && argv[i + 1][0] != '-') {
+        // A lone "-" is a value (stdout), not an option
+        if (key[0] == '-' && i + 1 < argc &&
+            (argv[i + 1][0] != '-' || std::string(argv[i + 1]) == "-")) {
             options[key] = argv[i + 1];
             i++;
         } else if (key[0] == '-') {
@@ -67,8 +91,47 @@ bool parseConfigs(int argc, char **argv, Config &config)
                   << "  -b, --bmname         Define the benchmark to run\n"
                   << "  -c, --config         Specify a YAML config file\n"
                   << "  -r, --repeats        Number of times the benchmark should be repeated\n"
+                  << "  -w, --warmup         Number of discarded warmup repeats\n"
+                  << "      --target-ci      Repeat until the relative 95% confidence interval\n"
+                  << "                       of the CI metric is below this value (e.g. 0.01)\n"
+                  << "      --ci-metric      Metric used for --target-ci (default: time_ns)\n"
+                  << "      --max-repeats    Maximum number of repeats with --target-ci\n"
+                  << "      --max-time       Maximum time in seconds with --target-ci\n"
+                  << "      --outliers       Exclude samples more than N MADs from the median\n"
+                  << "      --noise          Repeats perturbed by interrupts, context switches,\n"
+                  << "                       migrations, page faults or frequency changes:\n"
+                  << "                       off (default), flag or discard\n"
+                  << "      --max-interrupts Interrupts tolerated per repeat (default: 0)\n"
+                  << "      --max-page-faults Page faults tolerated per repeat (default: 16)\n"
+                  << "      --freq-tolerance Tolerated frequency deviation (default: 0.05)\n"
+                  << "      --null           Subtract the null variant of the benchmark and\n"
+                  << "                       report the net cost per operation\n"
+                  << "  -o, --output         Write the results to a file ('-' for stdout)\n"
+                  << "  -f, --format         Format of the results: json (lines) or csv\n"
                   << "  -m, --m5ops          Enable m5ops to reset and dump stats between repeats\n"
-                  << "  -z, --perf           Enable perf"
+                  << "      --m5-checkpoint  Take a gem5 checkpoint after init() of the first\n"
+                  << "                       benchmark, before the first repeat\n"
+                  << "      --m5-switch-cpu  Switch the gem5 CPU (m5_switch_cpu) before the N-th\n"
+                  << "                       repeat, counting warmup repeats\n"
+                  << "      --m5-transport   Transport of the m5ops: inst (default), addr (mapped\n"
+                  << "                       m5op region, for KVM) or semi (Arm semihosting)\n"
+                  << "      --m5-addr        Physical address of the m5op region for addr\n"
+                  << "      --m5-phases      Reset and dump the gem5 stats per phase instead of\n"
+                  << "                       work items: init, warmup, measure, teardown,\n"
+                  << "                       region (benchmark sub-regions), null\n"
+                  << "  -z, --perf           Measure each repeat with perf counters\n"
+                  << "  -e, --events         Comma separated perf events or presets (branch,\n"
+                  << "                       frontend, memory, tlb)\n"
+                  << "      --group-size     Maximum number of perf events per group\n"
+                  << "      --rdpmc          Read the perf counters in user space (rdpmc)\n"
+                  << "  -t, --timer          Measure each repeat with the cycle/tick counter\n"
+                  << "  -p, --pin            Pin the measuring thread to a core\n"
+                  << "      --threads        Run a copy of the benchmark on N threads at once\n"
+                  << "      --fifo           Run with SCHED_FIFO and the given priority (1-99)\n"
+                  << "      --mlock          Lock and prefault all memory (mlockall)\n"
+                  << "      --no-aslr        Re-execute with address space randomization disabled\n"
+                  << "      --shuffle        Run the suite entries and sweep points in random order\n"
+                  << "      --seed           Seed for --shuffle (default: random)\n"
                   << "  -l, --list           List all available benchmarks\n"
                   << "\n";
         return false;
@@ -86,14 +149,145 @@ bool parseConfigs(int argc, char **argv, Config &config)
         config.repeats = std::stoi(options.count("-r") ? options["-r"] : options["--repeats"]);
     }
 
+    if (options.count("-w") || options.count("--warmup")) {
+        config.warmup = std::stoi(options.count("-w") ? options["-w"] : options["--warmup"]);
+    }
+
+    if (options.count("--target-ci")) {
+        config.target_ci = std::stod(options["--target-ci"]);
+    }
+
+    if (options.count("--ci-metric")) {
+        config.ci_metric = options["--ci-metric"];
+    }
+
+    if (options.count("--max-repeats")) {
+        config.max_repeats = std::stoi(options["--max-repeats"]);
+    }
+
+    if (options.count("--max-time")) {
+        config.max_time = std::stod(options["--max-time"]);
+    }
+
+    if (options.count("--outliers")) {
+        config.outlier_k = std::stod(options["--outliers"]);
+    }
+
+    if (options.count("--noise")) {
+        config.noise = options["--noise"];
+    }
+
+    if (options.count("--max-interrupts")) {
+        config.max_interrupts = std::stoi(options["--max-interrupts"]);
+    }
+
+    if (options.count("--max-page-faults")) {
+        config.max_page_faults = std::stoi(options["--max-page-faults"]);
+    }
+
+    if (options.count("--freq-tolerance")) {
+        config.freq_tolerance = std::stod(options["--freq-tolerance"]);
+    }
+
+    if (options.count("--null")) {
+        config.null_baseline = true;
+    }
+
+    if (config.noise != "off" && config.noise != "flag" &&
+        config.noise != "discard") {
+        std::cerr << "Unknown noise policy: " << config.noise
+                  << " (off, flag, discard)" << std::endl;
+        return false;
+    }
+
+    if (options.count("-o") || options.count("--output")) {
+        config.output = options.count("-o") ? options["-o"] : options["--output"];
+        // Keep stdout for the results, all other output goes to stderr
+        if (config.output == "-") {
+            resultStdout();
+        }
+    }
+
+    if (options.count("-f") || options.count("--format")) {
+        config.output_format = options.count("-f") ? options["-f"] : options["--format"];
+    }
+
     if (options.count("-m") || options.count("--m5ops")) {
         config.use_m5ops = true;
     }
 
+    if (options.count("--m5-checkpoint")) {
+        config.m5_checkpoint = true;
+    }
+
+    if (options.count("--m5-switch-cpu")) {
+        config.m5_switch_cpu = std::stoi(options["--m5-switch-cpu"]);
+    }
+
+    if (options.count("--m5-transport")) {
+        config.m5_transport = options["--m5-transport"];
+    }
+
+    if (options.count("--m5-addr")) {
+        config.m5_addr = std::stoull(options["--m5-addr"], nullptr, 0);
+    }
+
+    if (options.count("--m5-phases")) {
+        config.m5_phases = splitList(options["--m5-phases"]);
+    }
+
     if (options.count("-z") || options.count("--perf")) {
         config.use_perf = true;
     }
 
+    if (options.count("-e") || options.count("--events")) {
+        config.perf_events = splitList(options.count("-e") ? options["-e"] : options["--events"]);
+    }
+
+    if (options.count("--group-size")) {
+        config.perf_group_size = std::stoi(options["--group-size"]);
+    }
+
+    if (options.count("--rdpmc")) {
+        config.use_rdpmc = true;
+    }
+
+    if (options.count("-t") || options.count("--timer")) {
+        config.use_timer = true;
+    }
+
+    if (options.count("-p") || options.count("--pin")) {
+        config.cpu = std::stoi(options.count("-p") ? options["-p"] : options["--pin"]);
+    }
+
+    if (options.count("--threads")) {
+        config.threads = std::stoi(options["--threads"]);
+        if (config.threads < 1) {
+            std::cerr << "--threads must be at least 1" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.count("--fifo")) {
+        config.rt_priority = std::stoi(options["--fifo"]);
+    }
+
+    if (options.count("--mlock")) {
+        config.mlock = true;
+    }
+
+    if (options.count("--no-aslr")) {
+        config.no_aslr = true;
+    }
+
+    if (options.count("--shuffle")) {
+        config.shuffle = true;
+    }
+
+    if (options.count("--seed")) {
+        config.seed = std::stoul(options["--seed"]);
+    }
+
     if (options.count("-l") || options.count("--list")) {
         config.list_benchmarks = true;
         return true;
@@ -116,13 +310,261 @@ bool parseConfigs(int argc, char **argv, Config &config)
         // Load the config file
         std::cout << "Loading config file: " << config_file << std::endl;
         config.bm_config = YAML::LoadFile(config_file);
+
+        // A suite file lists the benchmarks under `benchmarks`
+        if (config.bm_config["benchmarks"]) {
+            config.suite = config.bm_config["benchmarks"];
+            if (!config.suite.IsSequence() || config.suite.size() == 0) {
+                std::cerr << "benchmarks must be a list of benchmark configs" << std::endl;
+                return false;
+            }
+            if (config.bm_config["shuffle"] && !options.count("--shuffle")) {
+                config.shuffle = config.bm_config["shuffle"].as<bool>();
+            }
+            if (config.bm_config["seed"] && !options.count("--seed")) {
+                config.seed = config.bm_config["seed"].as<unsigned>();
+            }
+            config.benchmark_name = "suite";
+            return true;
+        }
+
         if (!config.bm_config["benchmark"])
         {
             std::cerr << "No benchmark specified in config file" << std::endl;
-            return 1;
+            return false;
         }
         config.benchmark_name = config.bm_config["benchmark"].as<std::string>();
     }
 
     return true;
 }
+
+
+bool parseSize(const std::string &str, int64_t &value)
+{
+    if (str.empty()) {
+        return false;
+    }
+    int64_t unit = 1;
+    std::string num = str;
+    switch (str.back()) {
+        case 'K': case 'k': unit = 1024; break;
+        case 'M': case 'm': unit = 1024 * 1024; break;
+        case 'G': case 'g': unit = 1024 * 1024 * 1024; break;
+    }
+    if (unit != 1) {
+        num = str.substr(0, str.size() - 1);
+    }
+    try {
+        size_t pos = 0;
+        value = std::stoll(num, &pos) * unit;
+        return pos == num.size();
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+/**
+ * @brief Move the repeat policy and perf keys of a benchmark config into
+ * the config
+ */
+static bool applyPolicy(Config &config)
+{
+    YAML::Node &bm = config.bm_config;
+    try {
+        if (bm["repeats"]) {
+            config.repeats = bm["repeats"].as<int>();
+        }
+        if (bm["warmup"]) {
+            config.warmup = bm["warmup"].as<int>();
+        }
+        if (bm["target_ci"]) {
+            config.target_ci = bm["target_ci"].as<double>();
+        }
+        if (bm["ci_metric"]) {
+            config.ci_metric = bm["ci_metric"].as<std::string>();
+        }
+        if (bm["max_repeats"]) {
+            config.max_repeats = bm["max_repeats"].as<int>();
+        }
+        if (bm["max_time"]) {
+            config.max_time = bm["max_time"].as<double>();
+        }
+        if (bm["outliers"]) {
+            config.outlier_k = bm["outliers"].as<double>();
+        }
+        if (bm["noise"]) {
+            config.noise = bm["noise"].as<std::string>();
+        }
+        if (bm["max_interrupts"]) {
+            config.max_interrupts = bm["max_interrupts"].as<int>();
+        }
+        if (bm["max_page_faults"]) {
+            config.max_page_faults = bm["max_page_faults"].as<int>();
+        }
+        if (bm["freq_tolerance"]) {
+            config.freq_tolerance = bm["freq_tolerance"].as<double>();
+        }
+        if (bm["null_baseline"]) {
+            config.null_baseline = bm["null_baseline"].as<bool>();
+        }
+        if (bm["perf_events"]) {
+            config.perf_events = bm["perf_events"].IsSequence()
+                ? bm["perf_events"].as<std::vector<std::string>>()
+                : splitList(bm["perf_events"].as<std::string>());
+        }
+        if (bm["perf_group_size"]) {
+            config.perf_group_size = bm["perf_group_size"].as<int>();
+        }
+    } catch (const YAML::Exception &e) {
+        std::cerr << "Invalid repeat policy of " << config.benchmark_name
+                  << ": " << e.what() << std::endl;
+        return false;
+    }
+    for (auto key : {"repeats", "warmup", "target_ci", "ci_metric",
+                     "max_repeats", "max_time", "outliers", "noise",
+                     "max_interrupts", "max_page_faults", "freq_tolerance",
+                     "null_baseline", "perf_events", "perf_group_size"}) {
+        bm.remove(key);
+    }
+    return true;
+}
+
+bool expandSuite(const Config &config, std::vector<Config> &entries)
+{
+    entries.clear();
+    if (!config.suite.IsSequence()) {
+        Config entry = config;
+        entry.bm_config.reset(YAML::Clone(config.bm_config));
+        entries.push_back(entry);
+        return applyPolicy(entries.back());
+    }
+
+    for (size_t i = 0; i < config.suite.size(); i++) {
+        const YAML::Node &node = config.suite[i];
+        if (!node.IsMap() || !node["benchmark"]) {
+            std::cerr << "No benchmark specified in suite entry " << i << std::endl;
+            return false;
+        }
+        // Rebind the nodes of the copy, assigning them would overwrite
+        // the nodes of the suite
+        Config entry = config;
+        entry.suite.reset();
+        entry.bm_config.reset(YAML::Clone(node));
+        entry.benchmark_name = node["benchmark"].as<std::string>();
+        if (!applyPolicy(entry)) {
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+// Keys that are never expanded into sweeps
+static const std::set<std::string> reserved_keys = {
+    "benchmark",
+};
+
+/**
+ * @brief Expand a range `{from: A, to: B, scale: linear|geometric, steps: N}`
+ */
+static bool expandRange(const std::string &key, const YAML::Node &range,
+                        std::vector<YAML::Node> &values)
+{
+    int64_t from, to, step = 1;
+    std::string scale;
+    try {
+        for (const char *k : {"from", "to"}) {
+            if (!range[k]) {
+                std::cerr << "Range of " << key << " has no " << k
+                          << std::endl;
+                return false;
+            }
+        }
+        if (!parseSize(range["from"].as<std::string>(), from) ||
+            !parseSize(range["to"].as<std::string>(), to)) {
+            std::cerr << "Invalid range of " << key << std::endl;
+            return false;
+        }
+        scale = range["scale"] ? range["scale"].as<std::string>() : "linear";
+        if (scale == "geometric") {
+            step = 2;
+        }
+        const YAML::Node &s = range["steps"] ? range["steps"] : range["step"];
+        if (s && !parseSize(s.as<std::string>(), step)) {
+            std::cerr << "Invalid steps of " << key << std::endl;
+            return false;
+        }
+    } catch (const YAML::Exception &e) {
+        // Maps or sequences instead of scalars
+        std::cerr << "Invalid range of " << key << ": " << e.what()
+                  << std::endl;
+        return false;
+    }
+    bool geometric = scale == "geometric";
+    if (!geometric && scale != "linear") {
+        std::cerr << "Unknown scale of " << key << ": " << scale << std::endl;
+        return false;
+    }
+    if ((geometric && (step < 2 || from <= 0)) || (!geometric && step <= 0)) {
+        std::cerr << "Range of " << key << " does not terminate" << std::endl;
+        return false;
+    }
+
+    for (int64_t v = from; v <= to;) {
+        values.push_back(YAML::Node(v));
+        // Stop before the next value would overflow
+        if (geometric ? v > to / step : v > to - step) {
+            break;
+        }
+        v = geometric ? v * step : v + step;
+    }
+    return true;
+}
+
+bool expandSweep(const YAML::Node &bm_config, std::vector<YAML::Node> &points)
+{
+    points.clear();
+    points.push_back(YAML::Clone(bm_config));
+    if (!bm_config.IsMap()) {
+        return true;
+    }
+
+    for (auto it : bm_config) {
+        std::string key = it.first.as<std::string>();
+        const YAML::Node &val = it.second;
+        if (reserved_keys.count(key)) {
+            continue;
+        }
+
+        std::vector<YAML::Node> values;
+        if (val.IsSequence()) {
+            for (auto v : val) {
+                values.push_back(v);
+            }
+        } else if (val.IsMap() && (val["from"] || val["to"])) {
+            if (!expandRange(key, val, values)) {
+                return false;
+            }
+        } else {
+            continue;
+        }
+        if (values.empty()) {
+            std::cerr << "Empty sweep of " << key << std::endl;
+            return false;
+        }
+
+        // Cartesian product with the points so far. The last swept
+        // parameter changes fastest.
+        std::vector<YAML::Node> expanded;
+        for (auto &p : points) {
+            for (auto &v : values) {
+                YAML::Node point = YAML::Clone(p);
+                point[key] = YAML::Clone(v);
+                expanded.push_back(point);
+            }
+        }
+        points.swap(expanded);
+    }
+    return true;
+}
@@ -31,22 +31,121 @@
 #include <yaml-cpp/yaml.h>
 #include <string>
 #include <iostream>
+#include <vector>
 
 struct Config
 {
    std::string benchmark_name;
    bool use_m5ops;
+   // Take a gem5 checkpoint after init() of the first run
+   bool m5_checkpoint;
+   // Switch the gem5 CPU before this repeat of the first run, counting
+   // warmup repeats (-1 = never)
+   int m5_switch_cpu;
+   // How the m5ops reach gem5: "inst" (instructions), "addr" (mapped
+   // m5op region at `m5_addr`, 0 = default) or "semi" (Arm semihosting)
+   std::string m5_transport;
+   uint64_t m5_addr;
+   // Phases with gem5 stats (init, warmup, measure, teardown, region,
+   // null): reset at the begin, dumped at the end
+   std::vector<std::string> m5_phases;
    bool use_perf;
+   bool use_timer;
+   // Read the perf counters in user space (rdpmc)
+   bool use_rdpmc;
+   // Perf events, cache triples, raw codes or presets (see perf/events.hh)
+   std::vector<std::string> perf_events;
+   // Maximum number of events per counter group (0 = probe the PMU)
+   int perf_group_size;
    int repeats;
    YAML::Node bm_config;
 
+   /** Repeat policy */
+   // Number of repeats that are run before the measurement and discarded
+   int warmup;
+   // Target for the relative 95% confidence interval of `ci_metric`.
+   // If set, `repeats` is the minimum number of measured repeats and the
+   // runner continues until the target is met or a budget is exhausted.
+   double target_ci;
+   std::string ci_metric;
+   // Budget for the adaptive mode (0 = unlimited time)
+   int max_repeats;
+   double max_time;
+   // Samples further than `outlier_k` MADs from the median are excluded
+   // from the summary (0 = keep all samples)
+   double outlier_k;
+   // Repeats perturbed by the OS: "off" (not monitored), "flag" (reported)
+   // or "discard" (reported and excluded from the summary)
+   std::string noise;
+   // Interrupts of the measuring core tolerated per repeat
+   int max_interrupts;
+   // Page faults tolerated per repeat (first touches of stack or lazily
+   // mapped pages)
+   int max_page_faults;
+   // Tolerated deviation of the effective frequency from the median
+   double freq_tolerance;
+   // Measure the null variant of the benchmark and report the net cost
+   // per operation
+   bool null_baseline;
+
+   /** Machine readable output ("-" for stdout) and its format */
+   std::string output;
+   std::string output_format;
+
+   /** Execution environment */
+   // Core the measuring thread is pinned to (-1 = no pinning)
+   int cpu;
+   // Copies of the benchmark that run concurrently, one per thread
+   // (the measuring thread and threads - 1 workers)
+   int threads;
+   // SCHED_FIFO priority (0 = default scheduling)
+   int rt_priority;
+   // Lock and prefault all memory
+   bool mlock;
+   // Re-execute with address space layout randomization disabled
+   bool no_aslr;
+
+   /** Suite file: list of benchmark entries that run back-to-back */
+   YAML::Node suite;
+   // Run the entries and sweep points in a random order (0 = random seed)
+   bool shuffle;
+   unsigned seed;
+
     bool list_benchmarks;
 
     Config()
          : benchmark_name(""),
             use_m5ops(false),
+            m5_checkpoint(false),
+            m5_switch_cpu(-1),
+            m5_transport("inst"),
+            m5_addr(0),
             use_perf(false),
+            use_timer(false),
+            use_rdpmc(false),
+            perf_events({"cycles", "instructions", "branch-misses", "cache-misses"}),
+            perf_group_size(0),
             repeats(1),
+            warmup(0),
+            target_ci(0),
+            ci_metric("time_ns"),
+            max_repeats(1000),
+            max_time(0),
+            outlier_k(0),
+            noise("off"),
+            max_interrupts(0),
+            max_page_faults(16),
+            freq_tolerance(0.05),
+            null_baseline(false),
+            output(""),
+            output_format("json"),
+            cpu(-1),
+            threads(1),
+            rt_priority(0),
+            mlock(false),
+            no_aslr(false),
+            shuffle(false),
+            seed(0),
             list_benchmarks(false)
     {
     }
@@ -56,13 +155,82 @@ struct Config
         std::cout << "----------------------------------------" << std::endl;
         std::cout << " Base Configuration" << std::endl;
         std::cout << "----------------------------------------" << std::endl;
-        std::cout << "Benchmark:\t" << benchmark_name << std::endl;
+        if (suite.IsSequence()) {
+            std::cout << "Suite:\t\t" << suite.size() << " benchmarks";
+            if (shuffle) {
+                std::cout << " (shuffled)";
+            }
+            std::cout << std::endl;
+        } else {
+            std::cout << "Benchmark:\t" << benchmark_name << std::endl;
+        }
         std::cout << "Repeats:\t" << repeats << std::endl;
-        std::cout << "Use m5ops:\t" << (use_m5ops ? "true" : "false") << std::endl;
-        std::cout << "Use perf:\t" << (use_perf ? "true" : "false") << std::endl;
+        std::cout << "Warmup:\t\t" << warmup << std::endl;
+        if (target_ci > 0) {
+            std::cout << "Target CI:\t" << target_ci << " (" << ci_metric
+                      << ", max " << max_repeats << " repeats";
+            if (max_time > 0) {
+                std::cout << ", " << max_time << " s";
+            }
+            std::cout << ")" << std::endl;
+        }
+        if (!output.empty()) {
+            std::cout << "Output:\t\t" << output << " (" << output_format
+                      << ")" << std::endl;
+        }
+        if (outlier_k > 0) {
+            std::cout << "Outliers:\t> " << outlier_k << " MAD" << std::endl;
+        }
+        std::cout << "Noise:\t\t" << noise;
+        if (noise != "off") {
+            std::cout << " (max " << max_interrupts << " interrupts, "
+                      << max_page_faults << " page faults, "
+                      << freq_tolerance * 100 << "% frequency)";
+        }
+        std::cout << std::endl;
+        std::cout << "Null baseline:\t" << (null_baseline ? "true" : "false") << std::endl;
+        if (cpu >= 0) {
+            std::cout << "Pinned to CPU:\t" << cpu << std::endl;
+        }
+        if (threads > 1) {
+            std::cout << "Threads:\t" << threads << std::endl;
+        }
+        if (rt_priority > 0) {
+            std::cout << "SCHED_FIFO:\t" << rt_priority << std::endl;
+        }
+        std::cout << "Lock memory:\t" << (mlock ? "true" : "false") << std::endl;
+        std::cout << "ASLR:\t\t" << (no_aslr ? "disabled" : "default") << std::endl;
+        std::cout << "Use m5ops:\t" << (use_m5ops ? "true" : "false");
+        if (m5_transport != "inst") {
+            std::cout << " (" << m5_transport << ")";
+        }
+        std::cout << std::endl;
+        if (m5_checkpoint) {
+            std::cout << "Checkpoint:\tafter init()" << std::endl;
+        }
+        if (!m5_phases.empty()) {
+            std::cout << "m5 phases:\t";
+            for (size_t i = 0; i < m5_phases.size(); i++) {
+                std::cout << (i ? ", " : "") << m5_phases[i];
+            }
+            std::cout << std::endl;
+        }
+        if (m5_switch_cpu >= 0) {
+            std::cout << "Switch CPU:\tbefore repeat " << m5_switch_cpu << std::endl;
+        }
+        std::cout << "Use perf:\t" << (use_perf ? "true" : "false")
+                  << (use_perf && use_rdpmc ? " (rdpmc)" : "") << std::endl;
+        if (use_perf) {
+            std::cout << "Perf events:\t";
+            for (size_t i = 0; i < perf_events.size(); i++) {
+                std::cout << (i ? ", " : "") << perf_events[i];
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Use timer:\t" << (use_timer ? "true" : "false") << std::endl;
         std::cout << "----------------------------------------" << std::endl;
 
-        if (bm_config.size() > 0) {
+        if (!suite.IsSequence() && bm_config.size() > 0) {
             std::cout << " Benchmark Configuration" << std::endl;
             std::cout << "----------------------------------------" << std::endl;
             // for (std::size_t i=0;i<bm_config.size();i++) {
@@ -82,4 +250,50 @@ struct Config
  * @param config Configuration struct to be filled
  * @return true if parsing was successful, false otherwise
  */
-bool parseConfigs(int argc, char **argv, Config &config);
\ No newline at end of file
+bool parseConfigs(int argc, char **argv, Config &config);
+
+/**
+ * @brief Parse an integer with an optional binary size suffix
+ * (K = 1024, M = 1024^2, G = 1024^3), e.g. "256M".
+ *
+ * @param str The string to parse
+ * @param value The parsed value
+ * @return true if parsing was successful, false otherwise
+ */
+bool parseSize(const std::string &str, int64_t &value);
+
+/**
+ * @brief Split a config into the configs of its suite entries.
+ *
+ * Each entry of a suite file is a benchmark config with its own
+ * parameters and may override the repeat policy (`repeats`, `warmup`,
+ * `target_ci`, `ci_metric`, `max_repeats`, `max_time`, `outliers`,
+ * `noise`, `max_interrupts`, `max_page_faults`, `freq_tolerance`,
+ * `null_baseline`) and the perf events (`perf_events`, `perf_group_size`).
+ * The command line options are the defaults for all entries. These keys
+ * are removed from the `bm_config` of the entry. A config that is not a
+ * suite results in a single entry.
+ *
+ * @param config The parsed configuration
+ * @param entries One configuration per suite entry
+ * @return true if parsing was successful, false otherwise
+ */
+bool expandSuite(const Config &config, std::vector<Config> &entries);
+
+/**
+ * @brief Expand the parameter sweeps of a benchmark config into the
+ * cartesian product of all sweep points.
+ *
+ * A parameter is swept if its value is
+ *  - a list, e.g. `stride: [1, 2, 4]`, or
+ *  - a range, e.g. `array_size: {from: 1K, to: 256M, scale: geometric, steps: 2}`.
+ *    `steps` is the increment of a linear range (default) and the factor
+ *    of a geometric range.
+ * All other parameters are copied into every point.
+ *
+ * @param bm_config The benchmark config
+ * @param points One config per sweep point. A config without sweeps
+ *               results in a single point.
+ * @return true if expanding was successful, false otherwise
+ */
+bool expandSweep(const YAML::Node &bm_config, std::vector<YAML::Node> &points);
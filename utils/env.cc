@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "env.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/personality.h>
+#include <unistd.h>
+
+bool reexecWithoutAslr(char **argv)
+{
+    int persona = personality(0xffffffff);
+    if (persona == -1) {
+        std::cerr << "personality(): " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (persona & ADDR_NO_RANDOMIZE) {
+        return true;
+    }
+    if (personality(persona | ADDR_NO_RANDOMIZE) == -1) {
+        std::cerr << "personality(ADDR_NO_RANDOMIZE): " << strerror(errno)
+                  << std::endl;
+        return false;
+    }
+
+    // The personality only applies to new address spaces. Re-run
+    // ourselves with the same arguments.
+    execv("/proc/self/exe", argv);
+    std::cerr << "execv(): " << strerror(errno) << std::endl;
+    return false;
+}
+
+bool pinToCpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+        std::cerr << "sched_setaffinity(" << cpu << "): " << strerror(errno)
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool setFifoPriority(int priority)
+{
+    struct sched_param param;
+    param.sched_priority = priority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) == -1) {
+        std::cerr << "sched_setscheduler(SCHED_FIFO, " << priority
+                  << "): " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool lockMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1) {
+        std::cerr << "mlockall(): " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Fault in the stack the benchmarks will run on
+    volatile char stack[256 * 1024];
+    prefault((void *)stack, sizeof(stack));
+    return true;
+}
+
+void prefault(void *addr, size_t size)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    volatile char *p = static_cast<volatile char *>(addr);
+    for (size_t off = 0; off < size; off += page) {
+        p[off] = p[off];
+    }
+}
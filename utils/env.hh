@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Control of the execution environment of the measurement: CPU pinning,
+ * real-time scheduling, locked memory and disabled address space layout
+ * randomization (ASLR).
+ *
+ * Branch predictors and caches are indexed with address bits. With ASLR
+ * the code and data of a benchmark land at different addresses in every
+ * run, which makes `btb-stress` or `cache-l1i` results vary from run to
+ * run. Disabling ASLR keeps the addresses stable across runs.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Re-execute the program with ASLR disabled.
+ *
+ * Does nothing if ASLR is already disabled for this process, e.g. after
+ * the re-exec. Does not return on success.
+ *
+ * @param argv The arguments of the program
+ * @return false if ASLR could not be disabled
+ */
+bool reexecWithoutAslr(char **argv);
+
+/**
+ * @brief Pin the calling thread to a single core
+ *
+ * @param cpu The core
+ * @return true on success, false otherwise
+ */
+bool pinToCpu(int cpu);
+
+/**
+ * @brief Run the calling thread with the SCHED_FIFO policy. Needs
+ * CAP_SYS_NICE (or root).
+ *
+ * @param priority The real-time priority (1-99)
+ * @return true on success, false otherwise
+ */
+bool setFifoPriority(int priority);
+
+/**
+ * @brief Lock all current and future pages of the process into memory.
+ *
+ * With MCL_FUTURE the kernel populates every new mapping immediately, so
+ * the memory a benchmark allocates in init() is faulted in before the
+ * measurement. The stack is prefaulted explicitly.
+ *
+ * @return true on success, false otherwise
+ */
+bool lockMemory();
+
+/**
+ * @brief Touch every page of a buffer to fault it in before the
+ * measurement.
+ *
+ * @param addr Start of the buffer
+ * @param size Size of the buffer in bytes
+ */
+void prefault(void *addr, size_t size);
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "jit.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils/configs.h"
+
+/** Upper bound for the size of a blob */
+static const int64_t max_size = 1LL << 30;
+
+namespace {
+
+/** Writes instructions to the blob */
+struct Emitter
+{
+    uint8_t *p;
+
+    void put8(uint8_t v) { *p++ = v; }
+
+    void put32(uint32_t v)
+    {
+        memcpy(p, &v, sizeof(v));
+        p += sizeof(v);
+    }
+
+    /** Distance from the current position to a target */
+    int64_t dist(const uint8_t *target) const { return target - p; }
+};
+
+bool fits(int64_t disp, int bits)
+{
+    return disp >= -(1LL << (bits - 1)) && disp < (1LL << (bits - 1));
+}
+
+#if defined(__x86_64__)
+
+const int insn_align = 1;
+
+void emitPrologue(Emitter &e, uint32_t n, uint8_t *first)
+{
+    e.put8(0xb8);               // mov eax, n
+    e.put32(n);
+    e.put8(0x85);               // test eax, eax
+    e.put8(0xc0);
+    e.put8(0xe9);               // jmp first
+    e.put32(e.dist(first) - 4);
+}
+
+bool emitBranch(Emitter &e, CodeBlob::BranchType type, uint8_t *target)
+{
+    // Short form if the displacement fits into 8 bits
+    int64_t disp = e.dist(target) - 2;
+    if (fits(disp, 8)) {
+        e.put8(type == CodeBlob::Jump ? 0xeb       // jmp rel8
+               : type == CodeBlob::Taken ? 0x75    // jne rel8
+               : 0x74);                            // je rel8
+        e.put8(disp);
+        return true;
+    }
+    if (type == CodeBlob::Jump) {
+        e.put8(0xe9);           // jmp rel32
+        e.put32(e.dist(target) - 4);
+    } else {
+        e.put8(0x0f);           // jne/je rel32
+        e.put8(type == CodeBlob::Taken ? 0x85 : 0x84);
+        e.put32(e.dist(target) - 4);
+    }
+    return true;
+}
+
+void emitNop(Emitter &e) { e.put8(0x90); }
+
+void emitReturn(Emitter &e) { e.put8(0xc3); }
+
+#elif defined(__aarch64__)
+
+const int insn_align = 4;
+
+void emitPrologue(Emitter &e, uint32_t n, uint8_t *first)
+{
+    e.put32(0x52800000 | ((n & 0xffff) << 5));         // movz w0, #lo
+    e.put32(0x72a00000 | ((n >> 16) << 5));            // movk w0, #hi, lsl 16
+    e.put32(0x14000000 | ((e.dist(first) >> 2) & 0x3ffffff));  // b first
+}
+
+bool emitBranch(Emitter &e, CodeBlob::BranchType type, uint8_t *target)
+{
+    int64_t disp = e.dist(target);
+    if (type == CodeBlob::Jump) {
+        if (!fits(disp, 28)) {
+            return false;
+        }
+        e.put32(0x14000000 | ((disp >> 2) & 0x3ffffff));          // b
+        return true;
+    }
+    if (!fits(disp, 21)) {
+        return false;
+    }
+    uint32_t op = type == CodeBlob::Taken ? 0x35000000 : 0x34000000;
+    e.put32(op | (((disp >> 2) & 0x7ffff) << 5));   // cbnz/cbz w0
+    return true;
+}
+
+void emitNop(Emitter &e) { e.put32(0xd503201f); }
+
+void emitReturn(Emitter &e) { e.put32(0xd65f03c0); }
+
+#elif defined(__riscv) && __riscv_xlen == 64
+
+const int insn_align = 4;
+
+uint32_t encodeJal(int64_t d)
+{
+    // jal x0, d
+    return ((d >> 20) & 1) << 31 | ((d >> 1) & 0x3ff) << 21 |
+           ((d >> 11) & 1) << 20 | ((d >> 12) & 0xff) << 12 | 0x6f;
+}
+
+void emitPrologue(Emitter &e, uint32_t n, uint8_t *first)
+{
+    int32_t hi = (int32_t)(n + 0x800) >> 12;
+    int32_t lo = (int32_t)n - (hi << 12);
+    e.put32((hi & 0xfffff) << 12 | 10 << 7 | 0x37);                // lui a0
+    e.put32((lo & 0xfff) << 20 | 10 << 15 | 10 << 7 | 0x1b);      // addiw a0
+    e.put32(encodeJal(e.dist(first)));                              // j first
+}
+
+bool emitBranch(Emitter &e, CodeBlob::BranchType type, uint8_t *target)
+{
+    int64_t d = e.dist(target);
+    if (type == CodeBlob::Jump) {
+        if (!fits(d, 21)) {
+            return false;
+        }
+        e.put32(encodeJal(d));
+        return true;
+    }
+    if (!fits(d, 13)) {
+        return false;
+    }
+    // bne a0, x0 (taken) or beq a0, x0 (not taken)
+    uint32_t funct3 = type == CodeBlob::Taken ? 1 : 0;
+    e.put32(((d >> 12) & 1) << 31 | ((d >> 5) & 0x3f) << 25 |
+            10 << 15 | funct3 << 12 | ((d >> 1) & 0xf) << 8 |
+            ((d >> 11) & 1) << 7 | 0x63);
+    return true;
+}
+
+void emitNop(Emitter &e) { e.put32(0x00000013); }
+
+void emitReturn(Emitter &e) { e.put32(0x00008067); }
+
+#else
+#define NO_JIT
+#endif
+
+} // anonymous namespace
+
+CodeBlob::CodeBlob()
+    : layout{2, 16, 0, Jump}, base(nullptr), size(0), entry(nullptr)
+{
+}
+
+CodeBlob::~CodeBlob()
+{
+    release();
+}
+
+const char *CodeBlob::name(BranchType type)
+{
+    switch (type) {
+        case Taken: return "taken";
+        case NotTaken: return "not_taken";
+        default: return "jump";
+    }
+}
+
+bool CodeBlob::configure(const YAML::Node &bm_config)
+{
+    struct { const char *key; int64_t *value; } sizes[] = {
+        {"num_branches", &layout.num_branches},
+        {"branch_spacing", &layout.spacing},
+        {"branch_offset", &layout.offset},
+    };
+    for (auto &s : sizes) {
+        if (bm_config[s.key] &&
+            !parseSize(bm_config[s.key].as<std::string>(), *s.value)) {
+            std::cerr << "Invalid " << s.key << ": "
+                      << bm_config[s.key].as<std::string>() << std::endl;
+            return false;
+        }
+    }
+    if (bm_config["branch_type"]) {
+        std::string type = bm_config["branch_type"].as<std::string>();
+        if (type == "jump") {
+            layout.type = Jump;
+        } else if (type == "taken") {
+            layout.type = Taken;
+        } else if (type == "not_taken") {
+            layout.type = NotTaken;
+        } else {
+            std::cerr << "Unknown branch_type: " << type
+                      << " (jump, taken, not_taken)" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CodeBlob::build()
+{
+    release();
+#ifdef NO_JIT
+    std::cerr << "Code blobs are not supported on this architecture"
+              << std::endl;
+    return false;
+#else
+    const Layout &l = layout;
+    if (l.num_branches <= 0 || l.num_branches > INT32_MAX ||
+        l.spacing <= 0 || l.offset < 0) {
+        std::cerr << "Invalid code blob: " << l.num_branches
+                  << " branches, spacing " << l.spacing << ", offset "
+                  << l.offset << std::endl;
+        return false;
+    }
+    if (l.spacing % insn_align || l.offset % insn_align) {
+        std::cerr << "branch_spacing and branch_offset must be multiples of "
+                  << insn_align << std::endl;
+        return false;
+    }
+
+    // The prologue sits in the first page, the chain starts at the offset
+    // in the following pages
+    size_t page = sysconf(_SC_PAGESIZE);
+    int64_t bytes = page + l.offset + l.num_branches * l.spacing + 16;
+    if (bytes > max_size) {
+        std::cerr << "Code blob too large: " << bytes << " bytes"
+                  << std::endl;
+        return false;
+    }
+    size = (bytes + page - 1) / page * page;
+
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        std::cerr << "mmap code blob: " << strerror(errno) << std::endl;
+        size = 0;
+        return false;
+    }
+    base = static_cast<uint8_t *>(ptr);
+
+    uint8_t *first = base + page + l.offset;
+    uint8_t *last = first + l.num_branches * l.spacing;
+
+    Emitter e{base};
+    emitPrologue(e, l.num_branches, first);
+    for (int64_t i = 0; i < l.num_branches; i++) {
+        uint8_t *next = first + (i + 1) * l.spacing;
+        e.p = first + i * l.spacing;
+        if (!emitBranch(e, l.type, next) || e.p > next) {
+            std::cerr << "Cannot encode a " << name(l.type)
+                      << " branch with a spacing of " << l.spacing
+                      << " bytes" << std::endl;
+            release();
+            return false;
+        }
+        while (e.p < next) {
+            emitNop(e);
+        }
+    }
+    e.p = last;
+    emitReturn(e);
+
+    if (mprotect(base, size, PROT_READ | PROT_EXEC) != 0) {
+        std::cerr << "mprotect code blob: " << strerror(errno) << std::endl;
+        release();
+        return false;
+    }
+    __builtin___clear_cache(reinterpret_cast<char *>(base),
+                            reinterpret_cast<char *>(base + size));
+    entry = reinterpret_cast<int (*)()>(base);
+    return true;
+#endif
+}
+
+void CodeBlob::release()
+{
+    if (base) {
+        munmap(base, size);
+    }
+    base = nullptr;
+    size = 0;
+    entry = nullptr;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Runtime generated branch sequences (code blobs).
+ *
+ * The BTB benchmarks need code with a given number of branches at given
+ * addresses. Generating it at compile time limits the sizes to the ones
+ * built in and makes the binary huge. A code blob is emitted in init()
+ * instead: a chain of `num_branches` branches, one every
+ * `branch_spacing` bytes, written into an anonymous mapping that is
+ * made executable afterwards. The first branch sits `branch_offset`
+ * bytes after a page boundary, so the PC bits of every branch are known.
+ *
+ *   entry:  n = num_branches; jump first
+ *   first:  branch (first + spacing); nop ...
+ *           branch (first + 2 * spacing); nop ...
+ *           ...
+ *           return n
+ *
+ * Branch types (`branch_type`):
+ *  - `jump`: unconditional direct jump
+ *  - `taken`: conditional branch that is always taken
+ *  - `not_taken`: conditional branch that is never taken, the padding
+ *    nops fall through to the next branch
+ *
+ * Supported on x86-64, AArch64 and RV64. The encodings restrict the
+ * spacing: AArch64 and RV64 need a multiple of 4, conditional branches on
+ * RV64 reach +-4 KiB and on AArch64 +-1 MiB.
+ */
+
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class CodeBlob
+{
+  public:
+    enum BranchType { Jump, Taken, NotTaken };
+
+    struct Layout
+    {
+        int64_t num_branches;
+        /** Distance between two branches in bytes */
+        int64_t spacing;
+        /** Offset of the first branch from a page boundary */
+        int64_t offset;
+        BranchType type;
+    };
+
+  private:
+    Layout layout;
+    uint8_t *base;
+    size_t size;
+    int (*entry)();
+
+  public:
+    CodeBlob();
+    ~CodeBlob();
+
+    CodeBlob(const CodeBlob &) = delete;
+    CodeBlob &operator=(const CodeBlob &) = delete;
+
+    /**
+     * @brief Read the layout from the benchmark config: `num_branches`
+     * (K and M suffixes), `branch_spacing`, `branch_offset` and
+     * `branch_type`. Missing keys keep their current value.
+     *
+     * @param bm_config The benchmark config
+     * @return true if the options are valid, false otherwise
+     */
+    bool configure(const YAML::Node &bm_config);
+
+    /**
+     * @brief Emit the branch chain of the layout into a new executable
+     * mapping. Releases the previous blob.
+     *
+     * @return true on success, false if the layout cannot be encoded or
+     * the mapping failed
+     */
+    bool build();
+
+    /** Run the chain once. Returns the number of branches. */
+    int run() const { return entry(); }
+
+    /** Unmap the blob */
+    void release();
+
+    Layout &getLayout() { return layout; }
+    const Layout &getLayout() const { return layout; }
+
+    /** Size of the mapping in bytes */
+    size_t getSize() const { return size; }
+
+    static const char *name(BranchType type);
+};
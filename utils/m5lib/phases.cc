@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Implementation of the phase markers.
+ */
+
+#include "phases.hh"
+
+#include <iostream>
+
+#include "transport.hh"
+
+static const char *phase_names[] = {
+    "init", "warmup", "measure", "teardown", "region", "null",
+};
+
+const char *phaseName(Phase phase)
+{
+    return phase_names[static_cast<int>(phase)];
+}
+
+bool PhaseMarker::configure(const std::vector<std::string> &phases)
+{
+    mask = 0;
+    for (auto &name : phases) {
+        bool found = false;
+        for (unsigned p = 0; p < sizeof(phase_names) / sizeof(*phase_names);
+             p++) {
+            if (name == phase_names[p]) {
+                mask |= 1u << p;
+                found = true;
+            }
+        }
+        if (!found) {
+            std::cerr << "Unknown phase: " << name << " (init, warmup, "
+                      << "measure, teardown, region, null)" << std::endl;
+            return false;
+        }
+    }
+
+    // Sub-regions run inside exec() of a warmup, measure or null repeat.
+    // The stats are global, the reset of a region would wipe the stats of
+    // the enclosing phase before its dump.
+    unsigned repeats = 1u << static_cast<unsigned>(Phase::Warmup) |
+                       1u << static_cast<unsigned>(Phase::Measure) |
+                       1u << static_cast<unsigned>(Phase::Null);
+    if (enabled(Phase::Region) && (mask & repeats)) {
+        std::cerr << "The region phase cannot be combined with the warmup, "
+                  << "measure or null phase" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void PhaseMarker::reset()
+{
+    m5ops.m5_reset_stats(0, 0);
+}
+
+void PhaseMarker::dump(Phase phase, const char *region)
+{
+    m5ops.m5_dump_stats(0, 0);
+    // Sub-regions run inside exec(), the labels are printed later
+    bool repeated = phase != Phase::Init && phase != Phase::Teardown;
+    labels.push_back({dumps++, phase, benchmark, point,
+                      repeated ? repeat : -1, region});
+}
+
+std::vector<PhaseLabel> PhaseMarker::takeLabels()
+{
+    std::vector<PhaseLabel> taken;
+    taken.swap(labels);
+    return taken;
+}
+
+PhaseMarker &phaseMarker()
+{
+    static PhaseMarker marker;
+    return marker;
+}
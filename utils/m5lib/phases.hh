@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Phases of a benchmark run for gem5. The stats of the simulator are reset
+ * at the begin of an enabled phase (m5_reset_stats) and dumped at its end
+ * (m5_dump_stats). Every dump is labelled with the phase, the repeat and
+ * the region, such that the n-th dump of stats.txt can be matched to the
+ * n-th label in the results.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/** Phases in the order of a run. The value is the phase ID. */
+enum class Phase
+{
+    Init = 0,
+    Warmup = 1,
+    Measure = 2,
+    Teardown = 3,
+    /** Sub-region marked by the benchmark inside exec() */
+    Region = 4,
+    /** Repeat of the null variant of the benchmark */
+    Null = 5,
+};
+
+const char *phaseName(Phase phase);
+
+/** Label of one stats dump */
+struct PhaseLabel
+{
+    /** Index of the dump in stats.txt, starting at 0 */
+    int dump;
+    Phase phase;
+    std::string benchmark;
+    int point;
+    /** Repeat the dump belongs to (-1 for init and teardown) */
+    int repeat;
+    /** Name of the sub-region (Region only) */
+    std::string region;
+};
+
+class PhaseMarker
+{
+  private:
+    /** Bit mask of the enabled phases */
+    unsigned mask;
+    int dumps;
+    std::string benchmark;
+    int point;
+    int repeat;
+    std::vector<PhaseLabel> labels;
+
+    void reset();
+    void dump(Phase phase, const char *region);
+
+  public:
+    PhaseMarker() : mask(0), dumps(0), point(0), repeat(-1) {}
+
+    /**
+     * @brief Enable the stats of the given phases
+     *
+     * @param phases Names of the phases (init, warmup, measure, teardown,
+     *        region, null)
+     * @return false if a phase is unknown
+     */
+    bool configure(const std::vector<std::string> &phases);
+
+    bool enabled(Phase phase) const
+    {
+        return mask & (1u << static_cast<unsigned>(phase));
+    }
+
+    bool active() const { return mask != 0; }
+
+    /** Benchmark and sweep point of the following phases */
+    void setRun(const std::string &name, int _point)
+    {
+        benchmark = name;
+        point = _point;
+        repeat = -1;
+    }
+
+    /** Start a phase. Warmup, measure and null phases set the repeat. */
+    void begin(Phase phase, int _repeat = -1)
+    {
+        if (phase == Phase::Warmup || phase == Phase::Measure ||
+            phase == Phase::Null) {
+            repeat = _repeat;
+        }
+        if (enabled(phase)) {
+            reset();
+        }
+    }
+
+    void end(Phase phase, const char *region = "")
+    {
+        if (enabled(phase)) {
+            dump(phase, region);
+        }
+    }
+
+    /** Return and clear the labels of the dumps so far */
+    std::vector<PhaseLabel> takeLabels();
+};
+
+/** The marker of the process. Used by the runner and the benchmarks. */
+PhaseMarker &phaseMarker();
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Implementation of the m5op transport selection.
+ */
+
+#include "transport.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+
+/** Base of the mapped m5op region, used by the address based ops */
+extern "C" {
+void *m5_mem = nullptr;
+}
+
+#if defined(__x86_64__)
+static const uint64_t default_addr = 0xFFFF0000;
+#else
+static const uint64_t default_addr = 0x10010000;
+#endif
+static const size_t region_size = 0x10000;
+
+M5OpTable m5ops = {
+#define M5OP(name, func) name,
+    M5OP_FOREACH
+#undef M5OP
+};
+
+static const M5OpTable addr_ops = {
+#define M5OP(name, func) M5OP_MERGE_TOKENS(name, _addr),
+    M5OP_FOREACH
+#undef M5OP
+};
+
+#if defined(__aarch64__)
+static const M5OpTable semi_ops = {
+#define M5OP(name, func) M5OP_MERGE_TOKENS(name, _semi),
+    M5OP_FOREACH
+#undef M5OP
+};
+#endif
+
+/** Map the m5op region through /dev/mem */
+static bool mapRegion(uint64_t addr)
+{
+    int fd = open("/dev/mem", O_RDWR | O_SYNC);
+    if (fd < 0) {
+        std::cerr << "Cannot open /dev/mem for the m5op region: "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    void *mem = mmap(nullptr, region_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, addr);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        std::cerr << "Cannot map the m5op region at 0x" << std::hex << addr
+                  << std::dec << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    m5_mem = mem;
+    return true;
+}
+
+bool selectM5Transport(const std::string &transport, uint64_t addr)
+{
+    if (transport == "inst") {
+        return true;
+    }
+    if (transport == "addr") {
+        if (!mapRegion(addr ? addr : default_addr)) {
+            return false;
+        }
+        m5ops = addr_ops;
+        return true;
+    }
+#if defined(__aarch64__)
+    if (transport == "semi") {
+        m5ops = semi_ops;
+        return true;
+    }
+#endif
+    std::cerr << "Unknown or unsupported m5op transport: " << transport
+              << std::endl;
+    return false;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Runtime selection of the m5op transport. The instruction based m5ops
+ * trap under KVM, the address based ops read from a mapped m5op region
+ * instead and the semihosting ops (Arm) use the semihosting interface.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "utils/m5lib/m5ops.h"
+
+/** The m5ops of one transport. The members have the names of the
+ *  instruction based ops, e.g. `m5ops.m5_work_begin(id, 0)`. */
+struct M5OpTable
+{
+#define M5OP(name, func) __typeof__(&::name) name;
+    M5OP_FOREACH
+#undef M5OP
+};
+
+/** The m5ops of the selected transport (default: instruction) */
+extern M5OpTable m5ops;
+
+/**
+ * @brief Select the transport of the m5ops
+ *
+ * @param transport "inst", "addr" or "semi" (Arm only)
+ * @param addr Physical address of the m5op region for "addr"
+ *        (0 = default of the architecture)
+ * @return false if the transport is unknown or the region cannot be mapped
+ */
+bool selectM5Transport(const std::string &transport, uint64_t addr = 0);
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "memory.hh"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "utils/env.hh"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+// From <numaif.h>. We call mbind directly to not depend on libnuma.
+#define UBENCH_MPOL_BIND 2
+#define UBENCH_MPOL_MF_STRICT (1 << 0)
+#define UBENCH_MPOL_MF_MOVE (1 << 1)
+
+// Largest node count of the kernel (MAX_NUMNODES with NODES_SHIFT 10)
+static const int max_numa_nodes = 1024;
+
+static const size_t thp_size = 2 * 1024 * 1024;
+
+Arena::Arena()
+    : backing(Small), numa_node(-1), alignment(64), prefault(true),
+      actual(Small), bound_node(-1)
+{
+}
+
+Arena::~Arena()
+{
+    release();
+}
+
+const char *Arena::name(Backing backing)
+{
+    switch (backing) {
+        case THP: return "thp";
+        case Huge2M: return "2m";
+        case Huge1G: return "1g";
+        default: return "4k";
+    }
+}
+
+size_t Arena::pageSize(Backing backing)
+{
+    switch (backing) {
+        case THP: return thp_size;
+        case Huge2M: return 2 * 1024 * 1024;
+        case Huge1G: return 1024 * 1024 * 1024;
+        default: return sysconf(_SC_PAGESIZE);
+    }
+}
+
+bool Arena::configure(const YAML::Node &bm_config)
+{
+    if (bm_config["pages"]) {
+        std::string pages = bm_config["pages"].as<std::string>();
+        if (pages == "4k" || pages == "4K") {
+            backing = Small;
+        } else if (pages == "thp") {
+            backing = THP;
+        } else if (pages == "2m" || pages == "2M") {
+            backing = Huge2M;
+        } else if (pages == "1g" || pages == "1G") {
+            backing = Huge1G;
+        } else {
+            std::cerr << "Unknown page backing: " << pages
+                      << " (4k, thp, 2m, 1g)" << std::endl;
+            return false;
+        }
+    }
+    if (bm_config["numa_node"]) {
+        numa_node = bm_config["numa_node"].as<int>();
+        if (numa_node < -1 || numa_node >= max_numa_nodes) {
+            std::cerr << "NUMA node must be between 0 and "
+                      << max_numa_nodes - 1 << " (-1: no binding)"
+                      << std::endl;
+            return false;
+        }
+    }
+    if (bm_config["alignment"]) {
+        alignment = bm_config["alignment"].as<size_t>();
+        if (alignment == 0 || (alignment & (alignment - 1))) {
+            std::cerr << "Alignment must be a power of two" << std::endl;
+            return false;
+        }
+    }
+    if (bm_config["prefault"]) {
+        prefault = bm_config["prefault"].as<bool>();
+    }
+    actual = backing;
+    bound_node = numa_node;
+    return true;
+}
+
+void *Arena::allocBytes(size_t size)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+
+    // Hugetlbfs: the kernel hands out aligned huge pages. Fall back to
+    // small pages if none are reserved.
+    void *addr = MAP_FAILED;
+    size_t map_size = 0;
+    size_t align = alignment;
+    if (backing == Huge2M || backing == Huge1G) {
+        size_t page = pageSize(backing);
+        map_size = (size + page - 1) / page * page;
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                    (backing == Huge2M ? MAP_HUGE_2MB : MAP_HUGE_1GB);
+        if (align > page) {
+            map_size += (align + page - 1) / page * page;
+        }
+        addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "Warning: MAP_HUGETLB (" << name(backing)
+                      << ") failed: " << strerror(errno)
+                      << ". Falling back to 4k pages. Maybe run:\n\t"
+                      << "echo N | sudo tee /sys/kernel/mm/hugepages/hugepages-"
+                      << page / 1024 << "kB/nr_hugepages" << std::endl;
+            actual = Small;
+        }
+    }
+
+    if (addr == MAP_FAILED) {
+        // THP needs 2M aligned memory to back it with huge pages
+        if (backing == THP && align < thp_size) {
+            align = thp_size;
+        }
+        size_t page = pageSize(Small);
+        map_size = (size + page - 1) / page * page;
+        if (align > page) {
+            map_size += align;
+        }
+        addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "mmap(" << map_size << "): " << strerror(errno)
+                      << std::endl;
+            return nullptr;
+        }
+        if (backing == THP && madvise(addr, map_size, MADV_HUGEPAGE) != 0) {
+            std::cerr << "Warning: madvise(MADV_HUGEPAGE): "
+                      << strerror(errno) << std::endl;
+            actual = Small;
+        }
+    }
+    mappings.push_back({addr, map_size});
+
+    // Bind before the first touch, the policy applies to new faults
+    if (numa_node >= 0) {
+        const size_t bits = sizeof(unsigned long) * 8;
+        std::vector<unsigned long> mask(numa_node / bits + 1, 0);
+        mask[numa_node / bits] = 1UL << (numa_node % bits);
+        if (syscall(SYS_mbind, addr, map_size, UBENCH_MPOL_BIND, mask.data(),
+                    mask.size() * bits,
+                    UBENCH_MPOL_MF_STRICT | UBENCH_MPOL_MF_MOVE) != 0) {
+            // Results must not claim a placement that never happened
+            std::cerr << "mbind(node " << numa_node << "): "
+                      << strerror(errno) << std::endl;
+            bound_node = -1;
+            return nullptr;
+        }
+    }
+
+    uintptr_t p = reinterpret_cast<uintptr_t>(addr);
+    p = (p + align - 1) & ~(uintptr_t)(align - 1);
+    if (prefault) {
+        ::prefault(reinterpret_cast<void *>(p), size);
+    }
+    return reinterpret_cast<void *>(p);
+}
+
+void Arena::release()
+{
+    for (auto &m : mappings) {
+        munmap(m.addr, m.size);
+    }
+    mappings.clear();
+}
+
+size_t Arena::hugeBytes() const
+{
+    // Sum AnonHugePages of every VMA that overlaps an allocation. The
+    // kernel may merge adjacent allocations into one VMA.
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlaps = false;
+    size_t bytes = 0;
+    while (std::getline(smaps, line)) {
+        uintptr_t start, end;
+        char dash;
+        std::istringstream is(line);
+        if (line.find("AnonHugePages:") == 0) {
+            size_t kb = 0;
+            std::string key;
+            is >> key >> kb;
+            if (overlaps) {
+                bytes += kb * 1024;
+            }
+        } else if ((is >> std::hex >> start >> dash >> end) && dash == '-') {
+            overlaps = false;
+            for (auto &m : mappings) {
+                uintptr_t a = reinterpret_cast<uintptr_t>(m.addr);
+                overlaps |= a < end && a + m.size > start;
+            }
+        }
+    }
+    return bytes;
+}
+
+void Arena::record(YAML::Node &bm_config) const
+{
+    Backing used = actual;
+    if (actual == THP) {
+        size_t mapped = 0;
+        for (auto &m : mappings) {
+            mapped += m.size;
+        }
+        double ratio = mapped ? (double)hugeBytes() / mapped : 0;
+        bm_config["thp_ratio"] = ratio;
+        // Untouched memory has no huge pages yet
+        if (prefault && ratio == 0) {
+            std::cerr << "Warning: no transparent huge pages were used"
+                      << std::endl;
+            used = Small;
+        }
+    }
+    bm_config["pages"] = name(used);
+    bm_config["numa_node"] = bound_node;
+}
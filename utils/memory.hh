@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Arena allocator for the working sets of the benchmarks.
+ *
+ * At large sizes the results of the array benchmarks are dominated by TLB
+ * misses and by the NUMA node the memory lands on. The arena maps every
+ * allocation with a selectable page backing, binds it to a NUMA node and
+ * prefaults it, so the benchmark measures the access pattern and not the
+ * page faults. All allocations are released together with the arena.
+ *
+ * The benchmark config selects the backing:
+ *  - `pages`: `4k` (default), `thp` (transparent huge pages via madvise),
+ *    `2m` or `1g` (hugetlbfs via MAP_HUGETLB)
+ *  - `numa_node`: NUMA node to bind the memory to (default: no binding).
+ *    The allocation fails if the memory cannot be bound.
+ *  - `alignment`: alignment of every allocation in bytes (default: 64)
+ *  - `prefault`: touch every page after the allocation (default: true)
+ */
+
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Arena
+{
+  public:
+    enum Backing { Small, THP, Huge2M, Huge1G };
+
+  private:
+    struct Mapping
+    {
+        void *addr;
+        size_t size;
+    };
+
+    Backing backing;
+    int numa_node;
+    size_t alignment;
+    bool prefault;
+
+    /** Backing of the allocations. Differs from the requested backing if
+     * no huge pages were available */
+    Backing actual;
+    /** NUMA node the allocations are bound to (-1: none) */
+    int bound_node;
+
+    std::vector<Mapping> mappings;
+
+    /** Map, bind and prefault `size` bytes */
+    void *allocBytes(size_t size);
+
+  public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Read the backing options from the benchmark config
+     *
+     * @param bm_config The benchmark config
+     * @return true if the options are valid, false otherwise
+     */
+    bool configure(const YAML::Node &bm_config);
+
+    /**
+     * @brief Allocate an array. The memory is zero initialized.
+     *
+     * @param count Number of elements
+     * @return The array or nullptr if the allocation failed
+     */
+    template <typename T>
+    T *alloc(size_t count)
+    {
+        return static_cast<T *>(allocBytes(count * sizeof(T)));
+    }
+
+    /** Unmap all allocations */
+    void release();
+
+    /** Bytes of the allocations backed by transparent huge pages */
+    size_t hugeBytes() const;
+
+    /** Write the backing that was actually used (`pages`, `thp_ratio`
+     * with THP) and the NUMA node (`numa_node`, -1 if not bound) into
+     * the benchmark config so that it ends up in the results */
+    void record(YAML::Node &bm_config) const;
+
+    static const char *name(Backing backing);
+    static size_t pageSize(Backing backing);
+};
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Structured metrics that a benchmark reports in addition to the
+ * measurements of the runner.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct Metric
+{
+    std::string name;
+    double value;
+    std::string unit;
+};
+
+/** Collects the named metrics of a benchmark for one repeat */
+class MetricSink
+{
+  private:
+    std::vector<Metric> metrics;
+
+  public:
+    /** A plain counter such as the number of executed branches */
+    void counter(const std::string &name, double value,
+                 const std::string &unit = "")
+    {
+        metrics.push_back({name, value, unit});
+    }
+
+    /** A derived rate `num / den`. Zero if `den` is zero. */
+    void rate(const std::string &name, double num, double den,
+              const std::string &unit = "")
+    {
+        metrics.push_back({name, den != 0 ? num / den : 0, unit});
+    }
+
+    const std::vector<Metric> &get() const { return metrics; }
+
+    void clear() { metrics.clear(); }
+};
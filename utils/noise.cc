@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "noise.hh"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sched.h>
+
+NoiseMonitor::NoiseMonitor()
+    : use_events(false), use_interrupts(false), cpu(-1), irq_cpu(-1),
+      irq_start(0), irq_count(0)
+{
+}
+
+bool NoiseMonitor::readInterrupts(int core, uint64_t &count)
+{
+    std::ifstream file("/proc/interrupts");
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        return false;
+    }
+
+    // The header names the online cores, e.g. "CPU0 CPU1 CPU3"
+    std::istringstream header(line);
+    std::string name;
+    int column = -1;
+    for (int i = 0; header >> name; i++) {
+        if (name == "CPU" + std::to_string(core)) {
+            column = i;
+            break;
+        }
+    }
+    if (column < 0) {
+        return false;
+    }
+
+    // One line per interrupt source: "<irq>: <count per core> ..."
+    count = 0;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        fields >> name;
+        uint64_t value = 0;
+        int i = 0;
+        while (i <= column && fields >> value) {
+            i++;
+        }
+        if (i == column + 1) {
+            count += value;
+        }
+    }
+    return true;
+}
+
+bool NoiseMonitor::init(int _cpu)
+{
+    cpu = _cpu;
+
+    events.registerCounter("context-switches", PERF_TYPE_SOFTWARE,
+                           PERF_COUNT_SW_CONTEXT_SWITCHES);
+    events.registerCounter("cpu-migrations", PERF_TYPE_SOFTWARE,
+                           PERF_COUNT_SW_CPU_MIGRATIONS);
+    events.registerCounter("page-faults", PERF_TYPE_SOFTWARE,
+                           PERF_COUNT_SW_PAGE_FAULTS);
+    use_events = events.init();
+
+    uint64_t count;
+    int core = cpu >= 0 ? cpu : sched_getcpu();
+    use_interrupts = readInterrupts(core, count);
+    if (!use_interrupts) {
+        std::cerr << "Cannot read the interrupts of CPU" << core
+                  << " from /proc/interrupts" << std::endl;
+    }
+    return use_events || use_interrupts;
+}
+
+void NoiseMonitor::snapshot()
+{
+    if (use_interrupts) {
+        irq_cpu = cpu >= 0 ? cpu : sched_getcpu();
+        irq_count = 0;
+        if (!readInterrupts(irq_cpu, irq_start)) {
+            irq_cpu = -1;
+        }
+    }
+}
+
+void NoiseMonitor::start()
+{
+    if (use_events) {
+        events.start();
+    }
+}
+
+void NoiseMonitor::stop()
+{
+    if (use_events) {
+        events.stop();
+    }
+    uint64_t irq_stop;
+    if (use_interrupts && irq_cpu >= 0 &&
+        readInterrupts(irq_cpu, irq_stop)) {
+        irq_count = irq_stop - irq_start;
+    }
+}
+
+void NoiseMonitor::metrics(MetricSink &sink)
+{
+    if (use_events) {
+        for (auto &c : events.getCounters()) {
+            sink.counter("noise_" + c.first, c.second, "events");
+        }
+    }
+    if (use_interrupts) {
+        sink.counter("noise_interrupts", irq_count, "interrupts");
+    }
+}
+
+std::vector<std::string> NoiseMonitor::perturbations(int max_interrupts,
+                                                     int max_page_faults)
+{
+    std::vector<std::string> reasons;
+    if (use_events) {
+        for (auto &c : events.getCounters()) {
+            double limit = c.first == "page-faults" ? max_page_faults : 0;
+            if (c.second > limit) {
+                reasons.push_back(c.first);
+            }
+        }
+    }
+    if (use_interrupts && (int64_t)irq_count > max_interrupts) {
+        reasons.push_back("interrupts");
+    }
+    return reasons;
+}
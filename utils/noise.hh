@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Detection of repeats that were perturbed by the operating system.
+ *
+ * Around every exec() the monitor counts the software events
+ * context-switches, cpu-migrations and page-faults and the interrupts the
+ * measuring core received (from /proc/interrupts). A repeat with a
+ * context switch or migration, or more than a tolerated number of page
+ * faults or interrupts, did not only measure the benchmark.
+ *
+ * Reading /proc/interrupts takes microseconds and pollutes the caches, so
+ * the interrupts are read before the benchmark is reset and after the
+ * measured region. They include the interrupts during the reset.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils/metrics.hh"
+#include "utils/perf/perf.hh"
+
+class NoiseMonitor
+{
+  private:
+    PerfEvent events;
+    bool use_events;
+    bool use_interrupts;
+    /** Core the interrupts are read for (-1 = the current core) */
+    int cpu;
+    int irq_cpu;
+    uint64_t irq_start;
+    uint64_t irq_count;
+
+    /** Sum of all interrupts of a core in /proc/interrupts */
+    bool readInterrupts(int core, uint64_t &count);
+
+  public:
+    NoiseMonitor();
+
+    /**
+     * @brief Open the software events and check /proc/interrupts
+     *
+     * @param _cpu The core the measurement is pinned to (-1 = not pinned)
+     * @return false if neither source is available
+     */
+    bool init(int _cpu);
+
+    /**
+     * Read the interrupts at the start. Call before the benchmark is
+     * reset, such that the reset brings its data back into the caches.
+     */
+    void snapshot();
+
+    /** Start counting the events. Call right before the measured region. */
+    void start();
+
+    /** Stop counting. Call right after the measured region. */
+    void stop();
+
+    /** The counts of the last region as `noise_*` metrics */
+    void metrics(MetricSink &sink);
+
+    /**
+     * @brief Reasons why the last region was perturbed
+     *
+     * @param max_interrupts Number of interrupts that are tolerated
+     * @param max_page_faults Number of page faults that are tolerated
+     * @return The names of the events that hit the region
+     */
+    std::vector<std::string> perturbations(int max_interrupts,
+                                           int max_page_faults);
+};
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "events.hh"
+
+#include <iostream>
+#include <map>
+
+// Generic hardware and software events as named by perf
+static const std::map<std::string, std::pair<uint32_t, uint64_t>> generic = {
+	{"cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+	{"cpu-cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+	{"instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+	{"cache-references", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+	{"cache-misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+	{"branches", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}},
+	{"branch-instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}},
+	{"branch-misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+	{"bus-cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES}},
+	{"stalled-cycles-frontend", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND}},
+	{"stalled-cycles-backend", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND}},
+	{"ref-cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES}},
+
+	{"cpu-clock", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK}},
+	{"task-clock", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK}},
+	{"page-faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}},
+	{"minor-faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN}},
+	{"major-faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ}},
+	{"context-switches", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}},
+	{"cpu-migrations", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS}},
+	{"alignment-faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_ALIGNMENT_FAULTS}},
+	{"emulation-faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_EMULATION_FAULTS}},
+};
+
+static const std::map<std::string, uint64_t> cache_ids = {
+	{"L1D", PERF_COUNT_HW_CACHE_L1D},
+	{"L1I", PERF_COUNT_HW_CACHE_L1I},
+	{"LLC", PERF_COUNT_HW_CACHE_LL},
+	{"dTLB", PERF_COUNT_HW_CACHE_DTLB},
+	{"iTLB", PERF_COUNT_HW_CACHE_ITLB},
+	{"branch", PERF_COUNT_HW_CACHE_BPU},
+	{"node", PERF_COUNT_HW_CACHE_NODE},
+};
+
+static const std::map<std::string, uint64_t> cache_ops = {
+	{"read", PERF_COUNT_HW_CACHE_OP_READ},
+	{"write", PERF_COUNT_HW_CACHE_OP_WRITE},
+	{"prefetch", PERF_COUNT_HW_CACHE_OP_PREFETCH},
+};
+
+static const std::map<std::string, uint64_t> cache_results = {
+	{"access", PERF_COUNT_HW_CACHE_RESULT_ACCESS},
+	{"miss", PERF_COUNT_HW_CACHE_RESULT_MISS},
+};
+
+// Presets for the architecture ubench is built for. Arm uses the
+// architected PMUv3 common events, which all Neoverse cores implement.
+// RISC-V only has the generic events the SBI PMU maps.
+static const std::map<std::string, std::vector<std::string>> presets = {
+#if defined(__aarch64__)
+	{"branch", {"r21:BR_RETIRED", "r22:BR_MIS_PRED_RETIRED",
+		    "r12:BR_PRED", "r10:BR_MIS_PRED"}},
+	{"frontend", {"r11:CPU_CYCLES", "r08:INST_RETIRED",
+		      "r23:STALL_FRONTEND", "r14:L1I_CACHE",
+		      "r01:L1I_CACHE_REFILL", "r02:L1I_TLB_REFILL"}},
+	{"memory", {"r04:L1D_CACHE", "r03:L1D_CACHE_REFILL",
+		    "r16:L2D_CACHE", "r17:L2D_CACHE_REFILL",
+		    "r37:LL_CACHE_MISS_RD", "r24:STALL_BACKEND"}},
+	{"tlb", {"r25:L1D_TLB", "r05:L1D_TLB_REFILL", "r26:L1I_TLB",
+		 "r02:L1I_TLB_REFILL", "r34:DTLB_WALK", "r35:ITLB_WALK"}},
+	{"topdown", {"r11:CPU_CYCLES", "r23:STALL_FRONTEND",
+		     "r24:STALL_BACKEND", "r4005:STALL_BACKEND_MEM",
+		     "r3a:OP_RETIRED", "r3b:OP_SPEC"}},
+#elif defined(__riscv)
+	{"branch", {"branches", "branch-misses"}},
+	{"frontend", {"cycles", "instructions", "L1I-read-access",
+		      "L1I-read-miss", "iTLB-read-miss"}},
+	{"memory", {"L1D-read-access", "L1D-read-miss", "L1D-write-access",
+		    "L1D-write-miss", "LLC-read-miss"}},
+	{"tlb", {"dTLB-read-access", "dTLB-read-miss", "iTLB-read-access",
+		 "iTLB-read-miss"}},
+#else
+	{"branch", {"branches", "branch-misses"}},
+	{"frontend", {"cycles", "instructions", "stalled-cycles-frontend",
+		      "L1I-read-miss", "iTLB-read-miss"}},
+	{"memory", {"L1D-read-access", "L1D-read-miss", "LLC-read-access",
+		    "LLC-read-miss"}},
+	{"tlb", {"dTLB-read-access", "dTLB-read-miss", "iTLB-read-miss"}},
+	// Intel perf metrics (Ice Lake and later). `slots` must lead the
+	// group. The level 2 events exist since Sapphire Rapids.
+	{"topdown", {"r0400:slots", "r8000:topdown-retiring",
+		     "r8100:topdown-bad-spec", "r8200:topdown-fe-bound",
+		     "r8300:topdown-be-bound", "r8400:topdown-heavy-ops",
+		     "r8500:topdown-br-mispredict", "r8600:topdown-fetch-lat",
+		     "r8700:topdown-mem-bound"}},
+#endif
+};
+
+std::vector<std::string> eventPresets()
+{
+	std::vector<std::string> names;
+	for (auto &p : presets) {
+		names.push_back(p.first);
+	}
+	return names;
+}
+
+static bool parseCacheEvent(const std::string &name, EventSpec &spec)
+{
+	size_t first = name.find('-');
+	size_t last = name.rfind('-');
+	if (first == std::string::npos || first == last) {
+		return false;
+	}
+	auto id = cache_ids.find(name.substr(0, first));
+	auto op = cache_ops.find(name.substr(first + 1, last - first - 1));
+	auto res = cache_results.find(name.substr(last + 1));
+	if (id == cache_ids.end() || op == cache_ops.end() ||
+	    res == cache_results.end()) {
+		return false;
+	}
+	spec.type = PERF_TYPE_HW_CACHE;
+	spec.config = id->second | (op->second << 8) | (res->second << 16);
+	return true;
+}
+
+static bool parseRawEvent(const std::string &name, EventSpec &spec)
+{
+	if (name.size() < 2 || name[0] != 'r') {
+		return false;
+	}
+	size_t colon = name.find(':');
+	std::string code = name.substr(1, colon == std::string::npos
+					      ? std::string::npos : colon - 1);
+	try {
+		size_t pos = 0;
+		spec.config = std::stoull(code, &pos, 16);
+		if (pos != code.size()) {
+			return false;
+		}
+	} catch (const std::exception &) {
+		return false;
+	}
+	spec.type = PERF_TYPE_RAW;
+	if (colon != std::string::npos) {
+		spec.name = name.substr(colon + 1);
+	}
+	return true;
+}
+
+bool resolveEvents(const std::vector<std::string> &names,
+		   std::vector<EventSpec> &specs)
+{
+	for (auto &name : names) {
+		auto preset = presets.find(name);
+		if (preset != presets.end()) {
+			if (!resolveEvents(preset->second, specs)) {
+				return false;
+			}
+			continue;
+		}
+
+		EventSpec spec;
+		spec.name = name;
+		auto it = generic.find(name);
+		if (it != generic.end()) {
+			spec.type = it->second.first;
+			spec.config = it->second.second;
+		} else if (!parseCacheEvent(name, spec) &&
+			   !parseRawEvent(name, spec)) {
+			std::cerr << "Unknown perf event: " << name << std::endl;
+			return false;
+		}
+
+		bool duplicate = false;
+		for (auto &s : specs) {
+			duplicate |= s.type == spec.type && s.config == spec.config;
+		}
+		if (!duplicate) {
+			specs.push_back(spec);
+		}
+	}
+	return true;
+}
+
+static std::unique_ptr<PerfEvent> openGroup(const std::vector<EventSpec> &specs,
+					    bool userRead, bool quiet = false)
+{
+	auto group = std::make_unique<PerfEvent>();
+	for (auto &spec : specs) {
+		group->registerCounter(spec.name, spec.type, spec.config);
+	}
+	if (!group->init(userRead, quiet)) {
+		return nullptr;
+	}
+	return group;
+}
+
+bool openEventGroups(const std::vector<EventSpec> &specs,
+		     std::vector<std::unique_ptr<PerfEvent>> &groups,
+		     bool userRead, int maxPerGroup)
+{
+	groups.clear();
+
+	// Greedily add events to the current group while it still fits. An
+	// event that cannot join the current group leads a new group. Only
+	// the events the kernel rejects on their own print errors and are
+	// dropped.
+	std::vector<EventSpec> current;
+	for (auto &spec : specs) {
+		auto alone = openGroup({spec}, false);
+		if (!alone) {
+			continue;
+		}
+		if (current.empty()) {
+			current = {spec};
+			continue;
+		}
+		std::vector<EventSpec> trial = current;
+		trial.push_back(spec);
+		auto probe = openGroup(trial, false, true);
+		bool fits = probe && probe->size() == trial.size() &&
+			    (maxPerGroup > 0 ? (int)trial.size() <= maxPerGroup
+					     : probe->schedulable());
+		if (fits) {
+			current = trial;
+			continue;
+		}
+		groups.push_back(openGroup(current, userRead));
+		current = {spec};
+	}
+	if (!current.empty()) {
+		groups.push_back(openGroup(current, userRead));
+	}
+
+	// Opening a group a second time can fail, e.g. if another process
+	// took the counters in between
+	for (auto it = groups.begin(); it != groups.end();) {
+		it = *it ? it + 1 : groups.erase(it);
+	}
+	return !groups.empty();
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Catalogue of perf events that can be requested in the benchmark config.
+ *
+ * An event is given as
+ *  - a generic perf name: `cycles`, `instructions`, `branch-misses`,
+ *    `page-faults`, ...
+ *  - a cache triple `<cache>-<op>-<result>`: `L1D-read-miss`,
+ *    `dTLB-read-access`, ... (caches: L1D, L1I, LLC, dTLB, iTLB, branch,
+ *    node; ops: read, write, prefetch; results: access, miss)
+ *  - a raw PMU event `r<hex>`, e.g. `r00c5`. `r<hex>:<name>` names it.
+ *  - a preset (`branch`, `frontend`, `memory`, `tlb`, `topdown`) that
+ *    expands into the events of the architecture ubench was built for.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/perf/perf.hh"
+
+struct EventSpec
+{
+	std::string name;
+	uint32_t type;
+	uint64_t config;
+};
+
+/**
+ * @brief Resolve event names and presets into event specs
+ *
+ * @param names Event names, cache triples, raw codes or presets
+ * @param specs The resolved events (duplicates are removed)
+ * @return false if a name is unknown
+ */
+bool resolveEvents(const std::vector<std::string> &names,
+		   std::vector<EventSpec> &specs);
+
+/**
+ * @brief Open the events in as few groups as the PMU can count at once.
+ *
+ * Events are added to a group as long as the group can still be scheduled
+ * on the PMU (probed by counting a short loop) or, if `maxPerGroup` is
+ * set, up to `maxPerGroup` events. The runner measures each group in a
+ * separate repeat. Events that cannot be opened are dropped.
+ *
+ * @param specs The events
+ * @param groups The opened groups
+ * @param userRead Read the counters in user space (see PerfEvent::init)
+ * @param maxPerGroup Maximum number of events per group (0 = probe)
+ * @return false if no event could be opened
+ */
+bool openEventGroups(const std::vector<EventSpec> &specs,
+		     std::vector<std::unique_ptr<PerfEvent>> &groups,
+		     bool userRead, int maxPerGroup = 0);
+
+/** Names of the available presets */
+std::vector<std::string> eventPresets();
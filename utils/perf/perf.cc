@@ -31,8 +31,10 @@
 #include "perf.hh"
 
 #include <error.h>
+#include <errno.h>
 
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
@@ -47,6 +49,8 @@ static long perf_event_open(struct perf_event_attr *hw_event, pid_t pid,
 
 double
 PerfEvent::event::readCounter() {
+	if (data.time_running == 0)
+		return 0;
 	double multiplexingCorrection = static_cast<double>(data.time_enabled) / static_cast<double>(data.time_running);
 	return static_cast<double>(data.value) * multiplexingCorrection;
 }
@@ -57,6 +61,8 @@ void PerfEvent::registerCounter(const std::string &name, uint64_t type,
 	events.push_back(event());
 	auto &event = events.back();
 	event.name = name;
+	event.fd = -1;
+	event.page = nullptr;
 	auto &pe = event.pe;
 	memset(&pe, 0, sizeof(struct perf_event_attr));
 	pe.type = static_cast<uint32_t>(type);
@@ -65,28 +71,156 @@ void PerfEvent::registerCounter(const std::string &name, uint64_t type,
 	pe.disabled = true;
 	pe.inherit = 1;
 	pe.inherit_stat = 0;
-	pe.exclude_kernel = false;
-	pe.exclude_hv = false;
-	pe.read_format =
+	// Only count the user space of the measured region. Kernel time
+	// would include the ioctl's that start and stop the counters.
+	// Software events such as page faults only happen in the kernel.
+	pe.exclude_kernel = type != PERF_TYPE_SOFTWARE;
+	pe.exclude_hv = true;
+	// One read() on the group leader returns all counters of the group
+	pe.read_format = PERF_FORMAT_GROUP |
 		PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
 }
 
-void PerfEvent::init()
+bool PerfEvent::init(bool userRead, bool quiet)
 {
 	if (!events.size()) {
 		std::cerr << "No counters configured" << std::endl;
+		return false;
 	}
-	events[0].fd = -1;
-	for (int i = 0; i < events.size(); i++) {
-		events[i].fd = perf_event_open(&(events[i].pe), 0, -1, events[0].fd,
-					       PERF_FLAG_FD_CLOEXEC);
 
-		if (events[i].fd == -1) {
-			std::cerr << "Error setting counter: " << events[i].name  << std::endl;
+#if defined(__aarch64__)
+	// arm64 grants user access per event (config1:1, "rdpmc" format
+	// attribute of the PMU)
+	if (userRead) {
+		for (auto &event : events) {
+			if (event.pe.type == PERF_TYPE_HARDWARE ||
+			    event.pe.type == PERF_TYPE_RAW) {
+				event.pe.config1 |= 0x2;
+			}
 		}
 	}
+#endif
 
-	initialized = true;
+	// The first counter that opens successfully becomes the group leader.
+	// Counters the PMU/kernel does not support are dropped so that the
+	// remaining group can still be scheduled.
+	int leader = -1;
+	for (auto it = events.begin(); it != events.end();) {
+		// User space reads need the group on the PMU all the time.
+		// The kernel does not allow to mmap inherited events and the
+		// reads only see the calling thread anyway.
+		it->pe.pinned = userRead && leader == -1;
+		if (userRead) {
+			it->pe.inherit = 0;
+		}
+		it->fd = perf_event_open(&(it->pe), 0, -1, leader,
+					 PERF_FLAG_FD_CLOEXEC);
+
+		if (it->fd == -1) {
+			if (!quiet) {
+				std::cerr << "Error setting counter: " << it->name
+					  << " (" << strerror(errno) << ")"
+					  << std::endl;
+			}
+			it = events.erase(it);
+			continue;
+		}
+		if (leader == -1) {
+			leader = it->fd;
+		}
+		++it;
+	}
+
+	initialized = !events.empty();
+	if (!initialized) {
+		return false;
+	}
+	gfd = events[0].fd;
+	// nr, time_enabled, time_running and one value per counter
+	group_buf.resize(3 + events.size());
+
+	if (userRead) {
+		user_read = mapUserRead();
+		if (!user_read) {
+			std::cerr << "User space counter reads not available. "
+				  << "Using read()" << std::endl;
+		}
+		// The counters run from setActive() on. start()/stop() take
+		// the difference of two user space reads.
+	}
+	return true;
+}
+
+void PerfEvent::setActive(bool active)
+{
+	if (!initialized || !user_read) {
+		return;
+	}
+	if (active) {
+		ioctl(gfd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(gfd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	} else {
+		ioctl(gfd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+bool PerfEvent::mapUserRead()
+{
+	if (!RDPMC_SUPPORTED) {
+		return false;
+	}
+	long page_size = sysconf(_SC_PAGESIZE);
+	for (auto &event : events) {
+		void *addr = mmap(nullptr, page_size, PROT_READ, MAP_SHARED,
+				  event.fd, 0);
+		if (addr == MAP_FAILED) {
+			std::cerr << "Error mapping counter: " << event.name
+				  << " (" << strerror(errno) << ")" << std::endl;
+			return false;
+		}
+		event.page = static_cast<perf_event_mmap_page *>(addr);
+		if (!event.page->cap_user_rdpmc) {
+			std::cerr << "No user space access to counter: "
+				  << event.name << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PerfEvent::schedulable()
+{
+	if (!initialized || user_read) {
+		return initialized;
+	}
+	ioctl(gfd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(gfd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	for (int i = 0; i < 100000; i++) {
+		asm volatile("" ::: "memory");
+	}
+	ioctl(gfd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	if (!readGroup()) {
+		return false;
+	}
+	// A group that does not fit is never scheduled (time_running = 0)
+	// or multiplexed (time_running < time_enabled)
+	return group_buf[2] > 0 && group_buf[2] == group_buf[1];
+}
+
+bool PerfEvent::readGroup()
+{
+	size_t size = group_buf.size() * sizeof(uint64_t);
+	if (read(gfd, group_buf.data(), size) != (ssize_t)size ||
+	    group_buf[0] != events.size()) {
+		std::cerr << "Error reading counter group" << std::endl;
+		return false;
+	}
+	for (size_t i = 0; i < events.size(); i++) {
+		events[i].data.time_enabled = group_buf[1];
+		events[i].data.time_running = group_buf[2];
+		events[i].data.value = group_buf[3 + i];
+	}
+	return true;
 }
 
 void PerfEvent::start()
@@ -100,38 +234,64 @@ void PerfEvent::start()
 	//   }
 	if (!initialized) {
 		std::cerr << "Counters not initialized " << std::endl;
+		return;
 	}
 
 	startTime = std::chrono::steady_clock::now();
 
+	if (user_read) {
+		asm volatile("" ::: "memory");
+		for (size_t i = 0; i < events.size(); i++) {
+			events[i].prev.value = readUser(i);
+		}
+		asm volatile("" ::: "memory");
+		return;
+	}
+
 	asm volatile("" ::: "memory");
-	ioctl(events[0].fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
-	ioctl(events[0].fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	ioctl(gfd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(gfd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
 	asm volatile("" ::: "memory");
 
 }
 
 PerfEvent::~PerfEvent()
 {
+	long page_size = sysconf(_SC_PAGESIZE);
 	for (auto &event : events) {
-		close(event.fd);
+		if (event.page)
+			munmap(event.page, page_size);
+		if (event.fd >= 0)
+			close(event.fd);
 	}
 }
 
 void PerfEvent::stop()
 {
+	if (!initialized) {
+		return;
+	}
+
+	if (user_read) {
+		asm volatile("" ::: "memory");
+		for (size_t i = 0; i < events.size(); i++) {
+			events[i].data.value = readUser(i) - events[i].prev.value;
+		}
+		asm volatile("" ::: "memory");
+		// Pinned to the PMU for the whole region, no multiplexing
+		// to correct for
+		for (auto &event : events) {
+			event.data.time_enabled = 1;
+			event.data.time_running = 1;
+		}
+		stopTime = std::chrono::steady_clock::now();
+		return;
+	}
 
 	asm volatile("" ::: "memory");
-	ioctl(events[0].fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	ioctl(gfd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
 
-	for (unsigned i = 0; i < events.size(); i++) {
-		auto &event = events[i];
-		if (read(event.fd, &event.data, sizeof(uint64_t) * 3) !=
-		    sizeof(uint64_t) * 3)
-			std::cerr << "Error reading counter " << event.name  << std::endl;
-		//  ioctl(event.fd, PERF_EVENT_IOC_DISABLE, 0);
-		// std::cout << "Setup: " << event.name << " " << event.fd << std::endl;
-	}
+	readGroup();
 
 	stopTime = std::chrono::steady_clock::now();
 
@@ -147,6 +307,15 @@ PerfEvent::getCounter(const std::string &name)
 	return -1;
 }
 
+std::map<std::string, double>
+PerfEvent::getCounters()
+{
+	std::map<std::string, double> counters;
+	for (auto& event : events)
+		counters[event.name] = event.readCounter();
+	return counters;
+}
+
 void PerfEvent::printCounters() {
 	int width = 15;
     for (auto event : events) {
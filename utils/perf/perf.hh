@@ -43,7 +43,8 @@
 // #include <stdint.h>
 // #include <errno.h>
 
-#include "util.hh"
+#include "utils/util.hh"
+#include "utils/perf/rdpmc.h"
 
 #include <error.h>
 #include <linux/perf_event.h>
@@ -63,6 +64,8 @@ class PerfEvent {
 		int fd;
 		read_format prev;
 		read_format data;
+		// Page of the event mapped for reading it in user space
+		perf_event_mmap_page *page;
 
       double readCounter();
       uint64_t readRaw() { return data.value; }
@@ -75,9 +78,20 @@ class PerfEvent {
 	// A group file descriptor
 	int gfd;
 	bool initialized;
+	// The counters are read in user space (rdpmc) instead of read()
+	bool user_read;
+	// Buffer for reading the whole group with one read()
+	std::vector<uint64_t> group_buf;
+
+	/** Map the events for user space reads. Returns false if a counter
+	 * cannot be read from user space. */
+	bool mapUserRead();
+
+	/** Read the whole group with a single read() into the events */
+	bool readGroup();
 
     public:
-	PerfEvent() : gfd(-1), initialized(false)
+	PerfEvent() : gfd(-1), initialized(false), user_read(false)
 	{
 	}
    // PerfEvent(std::string _name) :  gfd(-1), initialized(false), name(_name) {}
@@ -86,8 +100,64 @@ class PerfEvent {
 	void registerCounter(const std::string &name, uint64_t type,
 			     uint64_t eventID);
 
-	/** Initialize all counters */
-	void init();
+	/**
+	 * Initialize all counters. Counters that cannot be opened are dropped.
+	 * Returns false if no counter could be opened.
+	 *
+	 * With `userRead` the counters run continuously once the group is
+	 * activated (setActive()) and start()/stop()
+	 * read them in user space (rdpmc on x86, the PMU registers on arm64)
+	 * without a system call. Falls back to read() if the kernel does not
+	 * allow user space access. With `quiet` the dropped counters are not
+	 * reported.
+	 */
+	bool init(bool userRead = false, bool quiet = false);
+
+	/**
+	 * Enable (and reset) or disable a group that is read in user space.
+	 * The group is pinned, so only one of several such groups may be
+	 * active at a time; the others would not get counters and read 0.
+	 * No effect for groups read with read().
+	 */
+	void setActive(bool active);
+
+	/** True if the counters are read in user space */
+	bool hasUserRead() const { return user_read; }
+
+	/** Number of opened counters */
+	size_t size() const { return events.size(); }
+
+	/** Count a short loop and check that the whole group was on the PMU
+	 * all the time, i.e. the group fits into the available counters */
+	bool schedulable();
+
+	/**
+	 * Read counter `i` in user space. Only valid if hasUserRead(). Costs
+	 * a few ten cycles and can be used inside the measured region, e.g.
+	 * for per-iteration deltas of a counter.
+	 */
+	inline uint64_t readUser(size_t i) const
+	{
+		volatile perf_event_mmap_page *pc = events[i].page;
+		uint32_t seq, idx;
+		uint64_t count;
+		// The kernel updates the page under a sequence lock
+		do {
+			seq = pc->lock;
+			asm volatile("" ::: "memory");
+			idx = pc->index;
+			count = pc->offset;
+			if (pc->cap_user_rdpmc && idx) {
+				uint16_t width = pc->pmc_width;
+				int64_t pmc = rdpmc(idx - 1);
+				pmc <<= 64 - width;
+				pmc >>= 64 - width;
+				count += pmc;
+			}
+			asm volatile("" ::: "memory");
+		} while (pc->lock != seq);
+		return count;
+	}
 	void start();
 
 	~PerfEvent();
@@ -114,6 +184,9 @@ class PerfEvent {
 
 	double getCounter(const std::string &name);
 
+	/** All counters of the last measurement by name */
+	std::map<std::string, double> getCounters();
+
    void printCounters();
 };
 
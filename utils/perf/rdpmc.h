@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Read a hardware performance counter from user space.
+ *
+ * The index is the hardware counter index the kernel publishes in the
+ * mmap'd perf_event_mmap_page of an event (`index - 1`).
+ *
+ * x86: `rdpmc` is allowed while the event is mmap'd
+ *      (/sys/bus/event_source/devices/cpu/rdpmc = 1, the default).
+ * arm64: The event must be opened with `config1:1` and user access must be
+ *      enabled with `sysctl kernel.perf_user_access=1` (Linux 5.17+).
+ *      Index 31 is the cycle counter, all others are event counters.
+ */
+
+#ifndef __RDPMC_HH__
+#define __RDPMC_HH__
+
+#include <stdint.h>
+
+#if defined(__x86_64__)
+#define RDPMC_SUPPORTED 1
+
+static inline uint64_t rdpmc(uint32_t idx)
+{
+    uint32_t lo, hi;
+    asm volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(idx));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+#elif defined(__aarch64__)
+#define RDPMC_SUPPORTED 1
+
+#define RDPMC_EVCNTR(n)                                          \
+    case n:                                                      \
+        asm volatile("mrs %0, pmevcntr" #n "_el0" : "=r"(val)); \
+        break
+
+static inline uint64_t rdpmc(uint32_t idx)
+{
+    uint64_t val = 0;
+    switch (idx) {
+        RDPMC_EVCNTR(0); RDPMC_EVCNTR(1); RDPMC_EVCNTR(2);
+        RDPMC_EVCNTR(3); RDPMC_EVCNTR(4); RDPMC_EVCNTR(5);
+        RDPMC_EVCNTR(6); RDPMC_EVCNTR(7); RDPMC_EVCNTR(8);
+        RDPMC_EVCNTR(9); RDPMC_EVCNTR(10); RDPMC_EVCNTR(11);
+        RDPMC_EVCNTR(12); RDPMC_EVCNTR(13); RDPMC_EVCNTR(14);
+        RDPMC_EVCNTR(15); RDPMC_EVCNTR(16); RDPMC_EVCNTR(17);
+        RDPMC_EVCNTR(18); RDPMC_EVCNTR(19); RDPMC_EVCNTR(20);
+        RDPMC_EVCNTR(21); RDPMC_EVCNTR(22); RDPMC_EVCNTR(23);
+        RDPMC_EVCNTR(24); RDPMC_EVCNTR(25); RDPMC_EVCNTR(26);
+        RDPMC_EVCNTR(27); RDPMC_EVCNTR(28); RDPMC_EVCNTR(29);
+        RDPMC_EVCNTR(30);
+        case 31:
+            asm volatile("mrs %0, pmccntr_el0" : "=r"(val));
+            break;
+    }
+    return val;
+}
+#undef RDPMC_EVCNTR
+
+#else
+/* RISC-V: the kernel does not publish the counter index of an event to
+ * user space yet. Always fall back to read(). */
+#define RDPMC_SUPPORTED 0
+
+static inline uint64_t rdpmc(uint32_t idx)
+{
+    return 0;
+}
+#endif
+
+#endif // __RDPMC_HH__
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "topdown.hh"
+
+#include <initializer_list>
+
+static bool has(const std::map<std::string, double> &c,
+		std::initializer_list<const char *> names)
+{
+	for (auto name : names) {
+		if (!c.count(name)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Intel perf metrics: every topdown event counts its share of the slots */
+static void intelTopdown(const std::map<std::string, double> &c,
+			 MetricSink &sink)
+{
+	double slots = c.at("slots");
+	double retiring = c.at("topdown-retiring");
+	double bad_spec = c.at("topdown-bad-spec");
+	double fe_bound = c.at("topdown-fe-bound");
+	double be_bound = c.at("topdown-be-bound");
+
+	sink.rate("tma_retiring", retiring, slots, "fraction");
+	sink.rate("tma_bad_speculation", bad_spec, slots, "fraction");
+	sink.rate("tma_frontend_bound", fe_bound, slots, "fraction");
+	sink.rate("tma_backend_bound", be_bound, slots, "fraction");
+
+	if (c.count("topdown-heavy-ops")) {
+		double heavy = c.at("topdown-heavy-ops");
+		sink.rate("tma_heavy_operations", heavy, slots, "fraction");
+		sink.rate("tma_light_operations", retiring - heavy, slots,
+			  "fraction");
+	}
+	if (c.count("topdown-br-mispredict")) {
+		double mispredict = c.at("topdown-br-mispredict");
+		sink.rate("tma_branch_mispredicts", mispredict, slots,
+			  "fraction");
+		sink.rate("tma_machine_clears", bad_spec - mispredict, slots,
+			  "fraction");
+	}
+	if (c.count("topdown-fetch-lat")) {
+		double latency = c.at("topdown-fetch-lat");
+		sink.rate("tma_fetch_latency", latency, slots, "fraction");
+		sink.rate("tma_fetch_bandwidth", fe_bound - latency, slots,
+			  "fraction");
+	}
+	if (c.count("topdown-mem-bound")) {
+		double memory = c.at("topdown-mem-bound");
+		sink.rate("tma_memory_bound", memory, slots, "fraction");
+		sink.rate("tma_core_bound", be_bound - memory, slots,
+			  "fraction");
+	}
+}
+
+/** Arm PMUv3: cycle based equivalent from the stall events */
+static void armTopdown(const std::map<std::string, double> &c,
+		       MetricSink &sink)
+{
+	double cycles = c.at("CPU_CYCLES");
+	if (cycles == 0) {
+		return;
+	}
+	double fe_bound = c.at("STALL_FRONTEND") / cycles;
+	double be_bound = c.at("STALL_BACKEND") / cycles;
+	double busy = 1.0 - fe_bound - be_bound;
+	if (busy < 0) {
+		busy = 0;
+	}
+
+	sink.counter("tma_frontend_bound", fe_bound, "fraction");
+	sink.counter("tma_backend_bound", be_bound, "fraction");
+	if (has(c, {"OP_RETIRED", "OP_SPEC"}) && c.at("OP_SPEC") > 0) {
+		double retired = c.at("OP_RETIRED") / c.at("OP_SPEC");
+		sink.counter("tma_retiring", busy * retired, "fraction");
+		sink.counter("tma_bad_speculation", busy * (1.0 - retired),
+			     "fraction");
+	}
+	if (c.count("STALL_BACKEND_MEM")) {
+		double memory = c.at("STALL_BACKEND_MEM") / cycles;
+		sink.counter("tma_memory_bound", memory, "fraction");
+		sink.counter("tma_core_bound", be_bound - memory, "fraction");
+	}
+}
+
+void topdownMetrics(const std::map<std::string, double> &counters,
+		    MetricSink &sink)
+{
+	if (has(counters, {"slots", "topdown-retiring", "topdown-bad-spec",
+			   "topdown-fe-bound", "topdown-be-bound"})) {
+		intelTopdown(counters, sink);
+	} else if (has(counters, {"CPU_CYCLES", "STALL_FRONTEND",
+				  "STALL_BACKEND"})) {
+		armTopdown(counters, sink);
+	}
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Top-down microarchitecture analysis (TMA) level 1 and 2 derived from the
+ * perf counters of a repeat.
+ *
+ * Intel (Ice Lake and later): the `topdown` preset counts `slots` and the
+ * `topdown-*` metric events. Level 1 is the fraction of the slots that
+ * retired, were lost to bad speculation, or stalled in the frontend or
+ * backend. Level 2 (Sapphire Rapids and later) splits these further.
+ *
+ * Arm (Neoverse): the `topdown` preset counts `CPU_CYCLES`,
+ * `STALL_FRONTEND`, `STALL_BACKEND`, `STALL_BACKEND_MEM`, `OP_RETIRED` and
+ * `OP_SPEC`. Frontend and backend bound are the fractions of stalled
+ * cycles. The remaining cycles are split into retiring and bad speculation
+ * by the fraction of speculatively executed operations that retired.
+ * Backend bound is split into memory and core bound.
+ *
+ * Metrics are only derived if all the required counters were measured in
+ * the same repeat (group).
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "utils/metrics.hh"
+
+/**
+ * @brief Derive the TMA metrics (`tma_*`, fractions between 0 and 1) from
+ * the counters of a repeat.
+ *
+ * @param counters The perf counters by name
+ * @param sink Receives the derived metrics
+ */
+void topdownMetrics(const std::map<std::string, double> &counters,
+		    MetricSink &sink);
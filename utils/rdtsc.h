@@ -30,6 +30,7 @@
 #define __RDTSC_HH__
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <time.h>
 #include <iostream>
 
@@ -37,10 +38,12 @@
 /* this also works on apple. see mach_absolute_time assembly:
 https://opensource.apple.com/source/xnu/xnu-7195.50.7.100.1/libsyscall/wrappers/mach_absolute_time.s
  */
+/* The isb keeps the counter read from being executed early. */
 #define RDTSC_START(c)                                          \
     do                                                          \
     {                                                           \
-        asm volatile("mrs %0, cntvct_el0" : "=r"(c)::"memory"); \
+        asm volatile("isb\n\t"                                  \
+                     "mrs %0, cntvct_el0" : "=r"(c)::"memory"); \
     } while (0)
 #define RDTSC_STOP(c) RDTSC_START(c)
 #define RDTSC_UNIT                                    \
@@ -48,14 +51,21 @@ https://opensource.apple.com/source/xnu/xnu-7195.50.7.100.1/libsyscall/wrappers/
         uint64_t c;                                   \
         asm volatile("mrs %0, cntfrq_el0" : "=r"(c)); \
         (1000000000 / c);                             \
-    });
+    })
+/* Frequency of the virtual counter in Hz */
+#define RDTSC_FREQ                                    \
+    ({                                                \
+        uint64_t c;                                   \
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(c)); \
+        c;                                            \
+    })
 
 #elif __x86_64__
 #define RDTSC_DIRTY "%rax", "%rbx", "%rcx", "%rdx"
 #define RDTSC_START(cycles)                                         \
     do                                                              \
     {                                                               \
-        register unsigned cyc_high, cyc_low;                        \
+        unsigned cyc_high, cyc_low;                                 \
         asm volatile("CPUID\n\t"                                    \
                      "RDTSC\n\t"                                    \
                      "mov %%edx, %0\n\t"                            \
@@ -67,7 +77,7 @@ https://opensource.apple.com/source/xnu/xnu-7195.50.7.100.1/libsyscall/wrappers/
 #define RDTSC_STOP(cycles)                                          \
     do                                                              \
     {                                                               \
-        register unsigned cyc_high, cyc_low;                        \
+        unsigned cyc_high, cyc_low;                                 \
         asm volatile("RDTSCP\n\t"                                   \
                      "mov %%edx, %0\n\t"                            \
                      "mov %%eax, %1\n\t"                            \
@@ -76,6 +86,30 @@ https://opensource.apple.com/source/xnu/xnu-7195.50.7.100.1/libsyscall/wrappers/
         (cycles) = ((uint64_t)cyc_high << 32) | cyc_low;            \
     } while (0)
 #define RDTSC_UNIT 1
+
+#elif __riscv
+/* rdtime is readable from user space on all Linux versions. The cycle
+ * counter (rdcycle) needs perf_user_access to be enabled since Linux 6.6
+ * and is used if RDTSC_RISCV_CYCLE is defined. RISC-V has no user-level
+ * serializing instruction, the fence at least orders the memory accesses.
+ */
+#ifdef RDTSC_RISCV_CYCLE
+#define RDTSC_START(c)                                          \
+    do                                                          \
+    {                                                           \
+        asm volatile("fence\n\t"                                \
+                     "rdcycle %0" : "=r"(c)::"memory");         \
+    } while (0)
+#else
+#define RDTSC_START(c)                                          \
+    do                                                          \
+    {                                                           \
+        asm volatile("fence\n\t"                                \
+                     "rdtime %0" : "=r"(c)::"memory");          \
+    } while (0)
+#endif
+#define RDTSC_STOP(c) RDTSC_START(c)
+#define RDTSC_UNIT 1
 #else
 #error unknown platform
 #endif
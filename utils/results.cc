@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "results.hh"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static const char *csvHeader =
+    "type,benchmark,point,config,repeat,outlier,noise,rejected,metric,unit,"
+    "value,n,min,median,mean,p90,p99,stddev,rel_ci";
+
+static std::string jsonString(const std::string &s)
+{
+    std::ostringstream os;
+    os << '"';
+    for (char c : s) {
+        switch (c) {
+          case '"': os << "\\\""; break;
+          case '\\': os << "\\\\"; break;
+          case '\n': os << "\\n"; break;
+          case '\t': os << "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << static_cast<int>(c) << std::dec;
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+    return os.str();
+}
+
+static std::string jsonNumber(double v)
+{
+    if (!std::isfinite(v)) {
+        return "null";
+    }
+    std::ostringstream os;
+    os << std::setprecision(15) << v;
+    return os.str();
+}
+
+static std::string csvString(const std::string &s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+    std::string quoted = "\"";
+    for (char c : s) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// A number in the JSON grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+// YAML scalars like 0x10, .5, +5, 007 or nan are written as strings.
+static bool isNumber(const std::string &s)
+{
+    size_t i = 0;
+    auto digits = [&]() {
+        size_t start = i;
+        while (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+            i++;
+        }
+        return i > start;
+    };
+    if (i < s.size() && s[i] == '-') {
+        i++;
+    }
+    if (i < s.size() && s[i] == '0') {
+        i++;
+    } else if (!digits()) {
+        return false;
+    }
+    if (i < s.size() && s[i] == '.') {
+        i++;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < s.size() && (s[i] == '+' || s[i] == '-')) {
+            i++;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    return i == s.size();
+}
+
+std::string yamlToJson(const YAML::Node &node)
+{
+    std::ostringstream os;
+    switch (node.Type()) {
+      case YAML::NodeType::Map: {
+        os << '{';
+        bool first = true;
+        for (auto it : node) {
+            os << (first ? "" : ",") << jsonString(it.first.as<std::string>())
+               << ':' << yamlToJson(it.second);
+            first = false;
+        }
+        os << '}';
+        break;
+      }
+      case YAML::NodeType::Sequence: {
+        os << '[';
+        for (size_t i = 0; i < node.size(); i++) {
+            os << (i ? "," : "") << yamlToJson(node[i]);
+        }
+        os << ']';
+        break;
+      }
+      case YAML::NodeType::Scalar: {
+        const std::string &s = node.Scalar();
+        if (node.Tag() == "!") {
+            // Quoted scalars stay strings
+            os << jsonString(s);
+        } else if (isNumber(s) || s == "true" || s == "false") {
+            os << s;
+        } else {
+            os << jsonString(s);
+        }
+        break;
+      }
+      default:
+        os << (node.IsNull() ? "null" : "{}");
+    }
+    return os.str();
+}
+
+std::ostream &resultStdout()
+{
+    static std::ostream stdout_stream(std::cout.rdbuf());
+    static bool redirected = false;
+    if (!redirected) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+        redirected = true;
+    }
+    return stdout_stream;
+}
+
+bool ResultWriter::open(const std::string &path, const std::string &fmt)
+{
+    if (fmt == "json") {
+        format = JSON;
+    } else if (fmt == "csv") {
+        format = CSV;
+    } else {
+        std::cerr << "Unknown output format: " << fmt << std::endl;
+        return false;
+    }
+
+    if (path == "-") {
+        out = &resultStdout();
+    } else {
+        file.open(path);
+        if (!file) {
+            std::cerr << "Cannot open output file: " << path << std::endl;
+            return false;
+        }
+        out = &file;
+    }
+
+    if (format == CSV) {
+        *out << csvHeader << std::endl;
+    }
+    return true;
+}
+
+void ResultWriter::writeCsvRow(const std::string &type,
+                               const RunInfo &run,
+                               const std::string &config,
+                               const std::string &repeat,
+                               const std::string &outlier,
+                               const std::string &noise,
+                               const std::string &rejected,
+                               const std::string &metric,
+                               const std::string &unit,
+                               const std::string &values)
+{
+    *out << type << ',' << csvString(run.benchmark) << ',' << run.point
+         << ',' << csvString(config)
+         << ',' << repeat << ',' << outlier << ',' << csvString(noise)
+         << ',' << rejected << ',' << csvString(metric)
+         << ',' << csvString(unit) << ',' << values << '\n';
+}
+
+void ResultWriter::writeRepeat(const RunInfo &run, int id, bool outlier,
+                               const std::string &noise, bool rejected,
+                               const std::map<std::string, double> &metrics,
+                               const std::map<std::string, std::string> &units)
+{
+    if (!out) {
+        return;
+    }
+    std::string cfg = yamlToJson(run.config);
+
+    if (format == CSV) {
+        for (auto &m : metrics) {
+            auto u = units.find(m.first);
+            writeCsvRow("repeat", run, cfg, std::to_string(id),
+                        outlier ? "true" : "false", noise,
+                        rejected ? "true" : "false", m.first,
+                        u != units.end() ? u->second : "",
+                        jsonNumber(m.second) + ",,,,,,,,");
+        }
+        return;
+    }
+
+    *out << "{\"type\":\"repeat\",\"benchmark\":"
+         << jsonString(run.benchmark) << ",\"point\":" << run.point
+         << ",\"config\":" << cfg << ",\"repeat\":" << id
+         << ",\"outlier\":" << (outlier ? "true" : "false")
+         << ",\"noise\":" << jsonString(noise)
+         << ",\"rejected\":" << (rejected ? "true" : "false")
+         << ",\"metrics\":{";
+    bool first = true;
+    for (auto &m : metrics) {
+        *out << (first ? "" : ",") << jsonString(m.first) << ':'
+             << jsonNumber(m.second);
+        first = false;
+    }
+    *out << "},\"units\":{";
+    first = true;
+    for (auto &u : units) {
+        *out << (first ? "" : ",") << jsonString(u.first) << ':'
+             << jsonString(u.second);
+        first = false;
+    }
+    *out << "}}\n";
+}
+
+void ResultWriter::writeSummary(const RunInfo &run, size_t repeats,
+                                size_t rejected,
+                                const std::map<std::string, size_t> &reasons,
+                                const std::map<std::string, Summary> &summaries,
+                                const std::map<std::string, std::string> &units)
+{
+    if (!out) {
+        return;
+    }
+    std::string cfg = yamlToJson(run.config);
+
+    if (format == CSV) {
+        for (auto &s : summaries) {
+            auto u = units.find(s.first);
+            const Summary &sum = s.second;
+            std::ostringstream values;
+            values << ',' << sum.n << ',' << jsonNumber(sum.min) << ','
+                   << jsonNumber(sum.median) << ',' << jsonNumber(sum.mean)
+                   << ',' << jsonNumber(sum.p90) << ','
+                   << jsonNumber(sum.p99) << ',' << jsonNumber(sum.stddev)
+                   << ',' << jsonNumber(sum.rel_ci);
+            writeCsvRow("summary", run, cfg, "", "", "", "", s.first,
+                        u != units.end() ? u->second : "", values.str());
+        }
+        out->flush();
+        return;
+    }
+
+    *out << "{\"type\":\"summary\",\"benchmark\":"
+         << jsonString(run.benchmark) << ",\"point\":" << run.point
+         << ",\"config\":" << cfg << ",\"repeats\":" << repeats
+         << ",\"rejected\":" << rejected << ",\"rejected_reasons\":{";
+    bool first = true;
+    for (auto &r : reasons) {
+        *out << (first ? "" : ",") << jsonString(r.first) << ':' << r.second;
+        first = false;
+    }
+    *out << "},\"metrics\":{";
+    first = true;
+    for (auto &s : summaries) {
+        auto u = units.find(s.first);
+        const Summary &sum = s.second;
+        *out << (first ? "" : ",") << jsonString(s.first)
+             << ":{\"unit\":"
+             << jsonString(u != units.end() ? u->second : "")
+             << ",\"n\":" << sum.n
+             << ",\"min\":" << jsonNumber(sum.min)
+             << ",\"median\":" << jsonNumber(sum.median)
+             << ",\"mean\":" << jsonNumber(sum.mean)
+             << ",\"p90\":" << jsonNumber(sum.p90)
+             << ",\"p99\":" << jsonNumber(sum.p99)
+             << ",\"stddev\":" << jsonNumber(sum.stddev)
+             << ",\"rel_ci\":" << jsonNumber(sum.rel_ci) << '}';
+        first = false;
+    }
+    *out << "}}" << std::endl;
+}
+
+void ResultWriter::writeRegion(const RunInfo &run, int dump,
+                               const std::string &phase, int phase_id,
+                               int repeat, const std::string &region)
+{
+    if (!out) {
+        return;
+    }
+    std::string rep = repeat >= 0 ? std::to_string(repeat) : "";
+
+    if (format == CSV) {
+        std::string name = region.empty() ? phase : phase + "/" + region;
+        writeCsvRow("m5_region", run, "", rep, "", "", "", name, "dump",
+                    std::to_string(dump) + ",,,,,,,,");
+        out->flush();
+        return;
+    }
+
+    *out << "{\"type\":\"m5_region\",\"benchmark\":"
+         << jsonString(run.benchmark) << ",\"point\":" << run.point
+         << ",\"dump\":" << dump << ",\"phase\":" << jsonString(phase)
+         << ",\"phase_id\":" << phase_id
+         << ",\"repeat\":" << (rep.empty() ? "null" : rep)
+         << ",\"region\":" << jsonString(region) << "}" << std::endl;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Machine readable output of the measurements. One record is written per
+ * repeat and one per summary, either as JSON lines or as CSV.
+ *
+ * JSON lines: one object per line with the fields `type` ("repeat",
+ * "summary" or "m5_region"), `benchmark`, `point`, `config`, and the
+ * measurements.
+ * CSV: one row per metric of a record (long format) with the columns
+ * listed in `csvHeader`. The config is stored as a JSON string.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <yaml-cpp/yaml.h>
+
+#include "stats.hh"
+
+/** Identifies the run a record belongs to */
+struct RunInfo
+{
+    std::string benchmark;
+    /** Resolved config of the benchmark */
+    YAML::Node config;
+    /** Index of the sweep point */
+    int point;
+};
+
+/** Convert a YAML node into a JSON string */
+std::string yamlToJson(const YAML::Node &node);
+
+/**
+ * @brief Reserve stdout for the results
+ *
+ * Sends everything written to std::cout to stderr from now on, such
+ * that stdout only holds the machine readable records.
+ *
+ * @return The stream of the original stdout
+ */
+std::ostream &resultStdout();
+
+class ResultWriter
+{
+  public:
+    enum Format { JSON, CSV };
+
+  private:
+    std::ofstream file;
+    std::ostream *out;
+    Format format;
+
+    void writeCsvRow(const std::string &type, const RunInfo &run,
+                     const std::string &config, const std::string &repeat,
+                     const std::string &outlier, const std::string &noise,
+                     const std::string &rejected, const std::string &metric,
+                     const std::string &unit, const std::string &values);
+
+  public:
+    ResultWriter() : out(nullptr), format(JSON) {}
+    ~ResultWriter()
+    {
+        if (out) {
+            out->flush();
+        }
+    }
+
+    /**
+     * @brief Open the output
+     *
+     * @param path Output file or "-" for stdout
+     * @param fmt "json" or "csv"
+     * @return false if the file cannot be opened or the format is unknown
+     */
+    bool open(const std::string &path, const std::string &fmt);
+
+    bool isOpen() const { return out != nullptr; }
+
+    /**
+     * @brief Write the measurements of one repeat
+     *
+     * @param outlier The repeat is an outlier
+     * @param noise Comma separated events that perturbed the repeat
+     * @param rejected The repeat is excluded from the summary
+     */
+    void writeRepeat(const RunInfo &run, int id, bool outlier,
+                     const std::string &noise, bool rejected,
+                     const std::map<std::string, double> &metrics,
+                     const std::map<std::string, std::string> &units);
+
+    /**
+     * @brief Write the summary of all measured repeats
+     *
+     * @param rejected Number of repeats excluded from the summary
+     * @param reasons Number of rejected repeats per reason
+     */
+    void writeSummary(const RunInfo &run, size_t repeats, size_t rejected,
+                      const std::map<std::string, size_t> &reasons,
+                      const std::map<std::string, Summary> &summaries,
+                      const std::map<std::string, std::string> &units);
+
+    /**
+     * @brief Write the label of a gem5 stats dump
+     *
+     * @param dump Index of the dump in stats.txt
+     * @param phase Name of the phase
+     * @param phase_id ID of the phase
+     * @param repeat Repeat of the phase (-1 for init and teardown)
+     * @param region Name of the sub-region of the benchmark
+     */
+    void writeRegion(const RunInfo &run, int dump, const std::string &phase,
+                     int phase_id, int repeat, const std::string &region);
+};
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stats.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+/** Two sided 95% quantiles of the t-distribution for 1 to 30 degrees of
+ *  freedom. Above that the normal quantile is close enough. */
+static const double t95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+static double tQuantile95(size_t dof)
+{
+    if (dof == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (dof <= sizeof(t95) / sizeof(t95[0])) {
+        return t95[dof - 1];
+    }
+    return 1.960;
+}
+
+static double mean(const std::vector<double> &samples)
+{
+    return std::accumulate(samples.begin(), samples.end(), 0.0) /
+           samples.size();
+}
+
+static double stddev(const std::vector<double> &samples, double m)
+{
+    if (samples.size() < 2) {
+        return 0;
+    }
+    double sq = 0;
+    for (auto s : samples) {
+        sq += (s - m) * (s - m);
+    }
+    return std::sqrt(sq / (samples.size() - 1));
+}
+
+double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    double rank = p / 100.0 * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(rank));
+    size_t hi = static_cast<size_t>(std::ceil(rank));
+    double frac = rank - lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+double relativeCI(const std::vector<double> &samples)
+{
+    if (samples.size() < 2) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double m = mean(samples);
+    double s = stddev(samples, m);
+    // Constant samples, e.g. a counter that is always zero
+    if (s == 0) {
+        return 0;
+    }
+    if (m == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double half = tQuantile95(samples.size() - 1) * s /
+                  std::sqrt(static_cast<double>(samples.size()));
+    return std::fabs(half / m);
+}
+
+Summary summarize(const std::vector<double> &samples)
+{
+    Summary sum;
+    if (samples.empty()) {
+        return sum;
+    }
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    sum.n = sorted.size();
+    sum.min = sorted.front();
+    sum.max = sorted.back();
+    sum.median = percentile(sorted, 50);
+    sum.p90 = percentile(sorted, 90);
+    sum.p99 = percentile(sorted, 99);
+    sum.mean = mean(sorted);
+    sum.stddev = stddev(sorted, sum.mean);
+    sum.rel_ci = relativeCI(sorted);
+    return sum;
+}
+
+std::vector<bool> findOutliers(const std::vector<double> &samples, double k)
+{
+    std::vector<bool> outliers(samples.size(), false);
+    if (k <= 0 || samples.size() < 3) {
+        return outliers;
+    }
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    double med = percentile(sorted, 50);
+
+    std::vector<double> dev;
+    for (auto s : samples) {
+        dev.push_back(std::fabs(s - med));
+    }
+    std::sort(dev.begin(), dev.end());
+    // Scale the MAD so that it estimates the standard deviation of
+    // normally distributed samples.
+    double mad = 1.4826 * percentile(dev, 50);
+    if (mad == 0) {
+        return outliers;
+    }
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        outliers[i] = std::fabs(samples[i] - med) > k * mad;
+    }
+    return outliers;
+}
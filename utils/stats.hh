@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Descriptive statistics over the samples of repeated measurements.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/** Summary of a set of samples of one metric */
+struct Summary
+{
+    size_t n;
+    double min;
+    double max;
+    double median;
+    double mean;
+    double p90;
+    double p99;
+    double stddev;
+    /** Half width of the 95% confidence interval of the mean
+     *  relative to the mean. */
+    double rel_ci;
+
+    Summary()
+        : n(0), min(0), max(0), median(0), mean(0),
+          p90(0), p99(0), stddev(0), rel_ci(0)
+    {
+    }
+};
+
+/**
+ * @brief Compute the summary statistics of a set of samples
+ *
+ * @param samples The samples. An empty set results in an all zero summary.
+ * @return The summary
+ */
+Summary summarize(const std::vector<double> &samples);
+
+/**
+ * @brief Percentile with linear interpolation between closest ranks
+ *
+ * @param sorted Samples sorted in ascending order
+ * @param p Percentile in the range [0, 100]
+ */
+double percentile(const std::vector<double> &sorted, double p);
+
+/**
+ * @brief Half width of the 95% confidence interval of the mean relative
+ * to the mean (Student's t-distribution).
+ *
+ * @return The relative half width or infinity if it cannot be computed
+ *         (less than two samples or a mean of zero).
+ */
+double relativeCI(const std::vector<double> &samples);
+
+/**
+ * @brief Find outliers using the median absolute deviation (MAD).
+ * A sample is an outlier if it is more than k * MAD away from the median.
+ *
+ * @param samples The samples
+ * @param k Threshold in multiples of the (normal consistent) MAD.
+ *          k <= 0 disables the rejection.
+ * @return One flag per sample, true if the sample is an outlier.
+ */
+std::vector<bool> findOutliers(const std::vector<double> &samples, double k);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "timer.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+void RegionTimer::calibrate(int iterations, int freq_ms)
+{
+    // Overhead: median of many empty regions. The median is robust against
+    // the few regions that get hit by an interrupt.
+    std::vector<uint64_t> empty(iterations);
+    for (int i = 0; i < iterations; i++) {
+        uint64_t s = start();
+        uint64_t e = stop();
+        empty[i] = e - s;
+    }
+    std::sort(empty.begin(), empty.end());
+    overhead = static_cast<double>(empty[empty.size() / 2]);
+
+    // Frequency: Arm exposes the frequency of the generic timer. Everywhere
+    // else the ticks are measured against the steady clock.
+#ifdef RDTSC_FREQ
+    ticks_per_ns = static_cast<double>(RDTSC_FREQ) / 1e9;
+#else
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = start();
+    auto deadline = t0 + std::chrono::milliseconds(freq_ms);
+    auto t1 = t0;
+    while (t1 < deadline) {
+        t1 = std::chrono::steady_clock::now();
+    }
+    uint64_t c1 = stop();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    ticks_per_ns = static_cast<double>(c1 - c0) / ns;
+#endif
+    calibrated = true;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Region timer based on the cycle/tick counter of the CPU (see rdtsc.h).
+ *
+ * Reading the counter itself costs a few ten cycles. The timer measures
+ * this overhead at startup by timing empty regions and subtracts it from
+ * every measured region. The ticks are converted to nanoseconds with the
+ * measured frequency of the counter.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "utils/rdtsc.h"
+
+class RegionTimer
+{
+  private:
+    /** Ticks of an empty region */
+    double overhead;
+    /** Frequency of the counter in ticks per nanosecond */
+    double ticks_per_ns;
+    bool calibrated;
+
+  public:
+    RegionTimer()
+        : overhead(0), ticks_per_ns(1), calibrated(false)
+    {
+    }
+
+    static inline uint64_t start()
+    {
+        uint64_t c;
+        RDTSC_START(c);
+        return c;
+    }
+
+    static inline uint64_t stop()
+    {
+        uint64_t c;
+        RDTSC_STOP(c);
+        return c;
+    }
+
+    /**
+     * @brief Measure the overhead of an empty region and the frequency of
+     * the counter.
+     *
+     * @param iterations Number of empty regions that are timed
+     * @param freq_ms Duration in milliseconds of the frequency measurement
+     */
+    void calibrate(int iterations = 10000, int freq_ms = 20);
+
+    /** Ticks between start and stop without the timer overhead */
+    double net(uint64_t start, uint64_t stop) const
+    {
+        double ticks = static_cast<double>(stop - start) - overhead;
+        return ticks > 0 ? ticks : 0;
+    }
+
+    double toNs(double ticks) const { return ticks / ticks_per_ns; }
+
+    double getOverhead() const { return overhead; }
+    double getTicksPerNs() const { return ticks_per_ns; }
+    bool isCalibrated() const { return calibrated; }
+};
@@ -1,4 +1,7 @@
+#ifndef __ERROR_HH__
+#define __ERROR_HH__
 
+#include <iostream>
 
 /**
  * Conditional fatal macro that checks the supplied condition and only causes a
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "workers.hh"
+
+#include "utils/env.hh"
+
+WorkerPool::WorkerPool(int num, int first_cpu)
+    : begin_barrier(num + 1),
+      end_barrier(num + 1),
+      stop(false)
+{
+    for (int i = 1; i <= num; i++) {
+        threads.emplace_back(&WorkerPool::loop, this, i,
+                             first_cpu >= 0 ? first_cpu + i : -1);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop = true;
+    begin_barrier.arrive_and_wait();
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+void WorkerPool::loop(int tid, int cpu)
+{
+    if (cpu >= 0) {
+        pinToCpu(cpu);
+    }
+    while (true) {
+        // The barrier orders the job (and stop) before the workers
+        begin_barrier.arrive_and_wait();
+        if (stop) {
+            return;
+        }
+        job(tid);
+        end_barrier.arrive_and_wait();
+    }
+}
+
+void WorkerPool::start(std::function<void(int)> _job)
+{
+    job = std::move(_job);
+    begin_barrier.arrive_and_wait();
+}
+
+void WorkerPool::wait()
+{
+    end_barrier.arrive_and_wait();
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Technical University of Munich
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Worker threads that execute the copies of a benchmark on further cores
+ * in lockstep with the measuring thread (`--threads`).
+ *
+ * Every repeat releases all workers at once and waits until the last one
+ * finished, such that the copies run concurrently and the measured region
+ * covers all of them. The workers are started once and reused for every
+ * repeat. In gem5 SE mode each thread runs on its own simulated core.
+ */
+
+#pragma once
+
+#include <barrier>
+#include <functional>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+  private:
+    std::vector<std::thread> threads;
+    std::barrier<> begin_barrier;
+    std::barrier<> end_barrier;
+    /** Job of the current repeat, called with the thread ID */
+    std::function<void(int)> job;
+    bool stop;
+
+    void loop(int tid, int cpu);
+
+  public:
+    /**
+     * @brief Start the worker threads
+     *
+     * @param num Number of workers. They get the thread IDs 1 to num,
+     *            the measuring thread is 0.
+     * @param first_cpu Core of the measuring thread. Worker i is pinned
+     *            to first_cpu + i (-1 = no pinning).
+     */
+    WorkerPool(int num, int first_cpu = -1);
+    ~WorkerPool();
+
+    /** Release the workers to run job(tid) */
+    void start(std::function<void(int)> _job);
+
+    /** Wait until every worker finished the job */
+    void wait();
+
+    int size() const { return threads.size(); }
+};